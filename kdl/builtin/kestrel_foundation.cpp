@@ -18,14 +18,13 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <cstring>
 #include <kdl/builtin/kestrel_foundation.hpp>
 #include <kdl/builtin/posix_types.hpp>
-#include <kdl/lexer/lexer.hpp>
+#include <kdl/lexer/source_registry.hpp>
 
 // MARK: - Kestrel Types
 
-static bool s_kestrel_imported = false;
-
 static constexpr const char *kestrel_kdl = {R"(
 @module KestrelBinaryTypes {
     define(*type Color32) {
@@ -97,11 +96,9 @@ auto kdl::lib::builtin::kestrel::import(lexeme_consumer &consumer) -> void
 {
     builtin::posix::import(consumer);
 
-    if (!s_kestrel_imported) {
-        auto file = std::make_shared<source_file>(kestrel_kdl);
-        lexer sub_lexer { file };
-        consumer.insert(sub_lexer.scan(), 1);
+    static auto file = std::make_shared<source_file>(kestrel_kdl, std::strlen(kestrel_kdl));
+    auto& registry = source_registry::shared();
+    if (registry.mark_included(file)) {
+        consumer.insert(registry.tokens(file), 1);
     }
-
-    s_kestrel_imported = true;
 }
\ No newline at end of file
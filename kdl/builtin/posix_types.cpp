@@ -18,13 +18,12 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <cstring>
 #include <kdl/builtin/posix_types.hpp>
-#include <kdl/lexer/lexer.hpp>
+#include <kdl/lexer/source_registry.hpp>
 
 // MARK: - Posix Types
 
-static bool s_posix_imported = false;
-
 static constexpr const char *posix_kdl = {R"(
 @module POSIX {
     define(*type UInt8) {
@@ -77,10 +76,10 @@ static constexpr const char *posix_kdl = {R"(
 
 auto kdl::lib::builtin::posix::import(lexeme_consumer &consumer) -> void
 {
-    if (!s_posix_imported) {
-        auto file = std::make_shared<source_file>(posix_kdl);
-        lexer sub_lexer { file };
-        consumer.insert(sub_lexer.scan(), 1);
+    // The builtin source is only scanned once, but is imported once per parse.
+    static auto file = std::make_shared<source_file>(posix_kdl, std::strlen(posix_kdl));
+    auto& registry = source_registry::shared();
+    if (registry.mark_included(file)) {
+        consumer.insert(registry.tokens(file), 1);
     }
-    s_posix_imported = true;
 }
\ No newline at end of file
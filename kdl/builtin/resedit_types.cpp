@@ -18,13 +18,12 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <cstring>
 #include <kdl/builtin/resedit_types.hpp>
-#include <kdl/lexer/lexer.hpp>
+#include <kdl/lexer/source_registry.hpp>
 
 // MARK: - ResEdit Types
 
-static bool s_resedit_imported = false;
-
 static constexpr const char *resedit_kdl = {R"(
 @module ResEdit {
     define(*type DBYT) {
@@ -102,10 +101,9 @@ static constexpr const char *resedit_kdl = {R"(
 
 auto kdl::lib::builtin::resedit::import(lexeme_consumer& consumer) -> void
 {
-    if (!s_resedit_imported) {
-        auto file = std::make_shared<source_file>(resedit_kdl);
-        lexer sub_lexer { file };
-        consumer.insert(sub_lexer.scan(), 1);
+    static auto file = std::make_shared<source_file>(resedit_kdl, std::strlen(resedit_kdl));
+    auto& registry = source_registry::shared();
+    if (registry.mark_included(file)) {
+        consumer.insert(registry.tokens(file), 1);
     }
-    s_resedit_imported = true;
 }
@@ -25,8 +25,10 @@
 
 // MARK: - Constructor
 
-kdl::lib::file_reference::file_reference(std::shared_ptr<source_file> file, std::size_t pos, std::size_t line, std::size_t offset, std::size_t size)
-    : m_file(std::move(file)), m_absolute_position(pos - size), m_line_offset(offset), m_line(line), m_size(size)
+kdl::lib::file_reference::file_reference(const std::shared_ptr<source_file>& file, std::size_t pos, std::size_t size)
+    : m_file(file_registry::shared().register_file(file)),
+      m_absolute_position(static_cast<std::uint32_t>(pos)),
+      m_size(static_cast<std::uint32_t>(size))
 {
 
 };
@@ -35,12 +37,12 @@ kdl::lib::file_reference::file_reference(std::shared_ptr<source_file> file, std:
 
 auto kdl::lib::file_reference::valid() const -> bool
 {
-    return (m_file != nullptr);
+    return (m_file != file_registry::invalid_id);
 }
 
 auto kdl::lib::file_reference::file() const -> source_file&
 {
-    return *m_file;
+    return file_registry::shared().file(m_file);
 }
 
 auto kdl::lib::file_reference::absolute_position() const -> std::size_t
@@ -48,14 +50,19 @@ auto kdl::lib::file_reference::absolute_position() const -> std::size_t
     return m_absolute_position;
 }
 
+auto kdl::lib::file_reference::size() const -> std::size_t
+{
+    return m_size;
+}
+
 auto kdl::lib::file_reference::line_offset() const -> std::size_t
 {
-    return m_line_offset;
+    return m_absolute_position - file().line_start(line());
 }
 
 auto kdl::lib::file_reference::line() const -> std::size_t
 {
-    return m_line;
+    return file().line_containing(m_absolute_position);
 }
 
 // MARK: - Description
@@ -66,19 +73,12 @@ auto kdl::lib::file_reference::describe() const -> std::string
         return "<INVALID_FILE_REFERENCE>";
     }
     return "[" + std::to_string(m_absolute_position) + ":" + std::to_string(m_size) + "] "
-         + m_file->path() + ":L" + std::to_string(m_line) + ":" + std::to_string(m_line_offset);
+         + file().path() + ":L" + std::to_string(line()) + ":" + std::to_string(line_offset());
 }
 
 // MARK: - Source Lines
 
 auto kdl::lib::file_reference::complete_source_line() const -> std::string
 {
-    auto start = m_absolute_position - m_line_offset;
-    auto end = start;
-
-    while (m_file->source().at(end) != '\n') {
-        end++;
-    }
-
-    return m_file->source().substr(start, end - start);
+    return std::string(file().source_line(line()));
 }
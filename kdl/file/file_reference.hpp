@@ -22,27 +22,32 @@
 #define KDL_FILE_FILE_REFERENCE_HPP
 
 #include <memory>
+#include <cstdint>
 #include <kdl/file/source_file.hpp>
+#include <kdl/file/file_registry.hpp>
 
 namespace kdl::lib
 {
+    /* A reference to a range of a source file. The file is identified by its id in the file registry, keeping
+     * references small and cheap to copy. The line and offset within the line are derived from the line index of
+     * the file when they are requested, which is normally only when a diagnostic is being reported.
+     */
     class file_reference
     {
     private:
-        std::shared_ptr<source_file> m_file { nullptr };
-        std::size_t m_absolute_position { 0 };
-        std::size_t m_line_offset { 0 };
-        std::size_t m_line { 0 };
-        std::size_t m_size { 0 };
+        file_registry::id m_file { file_registry::invalid_id };
+        std::uint32_t m_absolute_position { 0 };
+        std::uint32_t m_size { 0 };
 
     public:
         file_reference() = default;
-        file_reference(std::shared_ptr<source_file> file, std::size_t pos, std::size_t line, std::size_t offset, std::size_t size);
+        file_reference(const std::shared_ptr<source_file>& file, std::size_t pos, std::size_t size);
 
         [[nodiscard]] auto valid() const -> bool;
 
         [[nodiscard]] auto file() const -> source_file&;
         [[nodiscard]] auto absolute_position() const -> std::size_t;
+        [[nodiscard]] auto size() const -> std::size_t;
         [[nodiscard]] auto line_offset() const -> std::size_t;
         [[nodiscard]] auto line() const -> std::size_t;
 
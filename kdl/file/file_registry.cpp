@@ -0,0 +1,83 @@
+// Copyright (c) 2021 Tom Hancocks
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdexcept>
+#include <kdl/file/file_registry.hpp>
+
+// MARK: - Construction
+
+kdl::lib::file_registry::~file_registry()
+{
+    for (auto& segment : m_segments) {
+        delete[] segment.load();
+    }
+}
+
+auto kdl::lib::file_registry::shared() -> file_registry&
+{
+    static file_registry registry;
+    return registry;
+}
+
+// MARK: - Registration
+
+auto kdl::lib::file_registry::register_file(const std::shared_ptr<source_file>& file) -> id
+{
+    if (auto existing = file->m_registry_id.load(std::memory_order_acquire); existing != invalid_id) {
+        return existing;
+    }
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (auto existing = file->m_registry_id.load(std::memory_order_relaxed); existing != invalid_id) {
+        return existing;
+    }
+
+    auto index = static_cast<std::size_t>(m_count.load(std::memory_order_relaxed));
+    auto segment = index / segment_size;
+    if (segment >= segment_count) {
+        throw std::length_error("Too many source files have been registered.");
+    }
+
+    auto entries = m_segments[segment].load(std::memory_order_relaxed);
+    if (!entries) {
+        entries = new std::shared_ptr<source_file>[segment_size];
+        m_segments[segment].store(entries, std::memory_order_release);
+    }
+    entries[index % segment_size] = file;
+
+    // Ids start at 1, so that a default constructed reference is invalid.
+    auto file_id = static_cast<id>(index + 1);
+    m_count.store(file_id, std::memory_order_release);
+    file->m_registry_id.store(file_id, std::memory_order_release);
+    return file_id;
+}
+
+// MARK: - Lookup
+
+auto kdl::lib::file_registry::file(id file_id) const -> source_file&
+{
+    auto index = static_cast<std::size_t>(file_id - 1);
+    return *m_segments[index / segment_size].load(std::memory_order_acquire)[index % segment_size];
+}
+
+auto kdl::lib::file_registry::count() const -> std::size_t
+{
+    return m_count.load(std::memory_order_acquire);
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2021 Tom Hancocks
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#if !defined(KDL_FILE_FILE_REGISTRY_HPP)
+#define KDL_FILE_FILE_REGISTRY_HPP
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <kdl/file/source_file.hpp>
+
+namespace kdl::lib
+{
+    /* The file registry assigns each source file that is referenced by a lexeme a small integer id, so that file
+     * references do not need to hold (and constantly copy) a shared pointer to the file. Files are kept alive by
+     * the registry once they have been registered.
+     *
+     * Registering a file takes a lock, but looking up a file by its id does not, so references can be resolved
+     * from multiple threads.
+     */
+    class file_registry
+    {
+    public:
+        using id = std::uint32_t;
+        static constexpr id invalid_id { 0 };
+
+        file_registry() = default;
+        ~file_registry();
+
+        file_registry(const file_registry&) = delete;
+        auto operator=(const file_registry&) -> file_registry& = delete;
+
+        static auto shared() -> file_registry&;
+
+        auto register_file(const std::shared_ptr<source_file>& file) -> id;
+        [[nodiscard]] auto file(id file_id) const -> source_file&;
+        [[nodiscard]] auto count() const -> std::size_t;
+
+    private:
+        static constexpr std::size_t segment_size { 1024 };
+        static constexpr std::size_t segment_count { 1024 };
+
+        std::mutex m_lock;
+        std::array<std::atomic<std::shared_ptr<source_file> *>, segment_count> m_segments {};
+        std::atomic<std::uint32_t> m_count { 0 };
+    };
+}
+
+#endif //KDL_FILE_FILE_REGISTRY_HPP
@@ -21,31 +21,102 @@
 #include <kdl/file/source_file.hpp>
 #include <utility>
 #include <fstream>
+#include <algorithm>
 
-// MARK: - Constructor
+#if __has_include(<sys/mman.h>)
+#   define KDL_SOURCE_FILE_MMAP
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#endif
 
-kdl::lib::source_file::source_file(std::string source, std::string path)
+// MARK: - Construction
+
+kdl::lib::source_file::source_file(std::string source, std::string path, load_mode mode)
     : m_file_path(std::move(path)), m_source(std::move(source))
 {
     if (m_source.empty() && m_file_path != memory) {
         // Attempt to load the contents of the file from disk.
-        std::ifstream file(m_file_path);
-        std::string str;
-        std::string contents;
-        while (std::getline(file, str)) {
-            contents += str;
-            contents.push_back('\n');
+        if (mode != load_mode::map || !map_file()) {
+            read_file();
+        }
+    }
+    else {
+        m_contents = m_source;
+    }
+}
+
+kdl::lib::source_file::source_file(const char *contents, std::size_t length, std::string path)
+    : m_file_path(std::move(path)), m_contents(contents, length), m_borrowed(true)
+{
+
+}
+
+kdl::lib::source_file::~source_file()
+{
+#if defined(KDL_SOURCE_FILE_MMAP)
+    if (m_mapping) {
+        munmap(m_mapping, m_mapping_size);
+    }
+#endif
+}
+
+// MARK: - Loading
+
+auto kdl::lib::source_file::map_file() -> bool
+{
+#if defined(KDL_SOURCE_FILE_MMAP)
+    auto fd = open(m_file_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info {};
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+
+    auto size = static_cast<std::size_t>(info.st_size);
+    auto mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    madvise(mapping, size, MADV_SEQUENTIAL);
+
+    m_mapping = mapping;
+    m_mapping_size = size;
+    m_contents = std::string_view(static_cast<const char *>(mapping), size);
+    return true;
+#else
+    return false;
+#endif
+}
+
+auto kdl::lib::source_file::read_file() -> void
+{
+    // Read the entire file in a single operation, into a buffer that has been sized up front.
+    std::ifstream file(m_file_path, std::ios::binary | std::ios::ate);
+    if (file.is_open()) {
+        auto size = file.tellg();
+        if (size > 0) {
+            m_source.resize(static_cast<std::size_t>(size));
+            file.seekg(0);
+            file.read(m_source.data(), size);
+            m_source.resize(static_cast<std::size_t>(file.gcount()));
         }
-        m_source = std::move(contents);
     }
-    m_source_size = m_source.size();
+    m_contents = m_source;
 }
 
 // MARK: - Accessors
 
-auto kdl::lib::source_file::source() const -> std::string
+auto kdl::lib::source_file::source() const -> std::string_view
 {
-    return m_source;
+    return m_contents;
 }
 
 auto kdl::lib::source_file::path() const -> std::string
@@ -55,7 +126,66 @@ auto kdl::lib::source_file::path() const -> std::string
 
 auto kdl::lib::source_file::size() const -> std::size_t
 {
-    return m_source_size;
+    return m_contents.size();
+}
+
+auto kdl::lib::source_file::is_mapped() const -> bool
+{
+    return m_mapping != nullptr;
+}
+
+auto kdl::lib::source_file::is_borrowed() const -> bool
+{
+    return m_borrowed;
+}
+
+// MARK: - Lines
+
+auto kdl::lib::source_file::line_starts() const -> const std::vector<std::size_t>&
+{
+    std::call_once(m_line_starts_built, [this] {
+        m_line_starts.reserve(m_contents.size() / 32 + 1);
+        m_line_starts.emplace_back(0);
+        for (auto nl = m_contents.find('\n'); nl != std::string_view::npos; nl = m_contents.find('\n', nl + 1)) {
+            m_line_starts.emplace_back(nl + 1);
+        }
+    });
+    return m_line_starts;
+}
+
+auto kdl::lib::source_file::line_count() const -> std::size_t
+{
+    return line_starts().size();
+}
+
+auto kdl::lib::source_file::line_start(std::size_t line) const -> std::size_t
+{
+    const auto& starts = line_starts();
+    if (line == 0 || line > starts.size()) {
+        return m_contents.size();
+    }
+    return starts[line - 1];
+}
+
+auto kdl::lib::source_file::line_end(std::size_t line) const -> std::size_t
+{
+    const auto& starts = line_starts();
+    if (line == 0 || line >= starts.size()) {
+        return m_contents.size();
+    }
+    return starts[line] - 1;
+}
+
+auto kdl::lib::source_file::line_containing(std::size_t offset) const -> std::size_t
+{
+    const auto& starts = line_starts();
+    return static_cast<std::size_t>(std::upper_bound(starts.begin(), starts.end(), offset) - starts.begin());
+}
+
+auto kdl::lib::source_file::source_line(std::size_t line) const -> std::string_view
+{
+    auto start = line_start(line);
+    return m_contents.substr(start, line_end(line) - start);
 }
 
 // MARK: - Path Operations
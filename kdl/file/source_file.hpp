@@ -22,27 +22,74 @@
 #define KDL_FILE_SOURCE_FILE_HPP
 
 #include <string>
+#include <string_view>
+#include <vector>
 #include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
 
 namespace kdl::lib
 {
+    class file_registry;
 
     class source_file: public std::enable_shared_from_this<source_file>
     {
+    public:
+        /* Source files on disk are memory mapped where the platform allows it, and the mapping is kept for the
+         * lifetime of the source file. Anything referencing the file (such as a lexeme) keeps it alive. Reading
+         * the file into an owned buffer can be requested explicitly, for files that may change on disk while
+         * they are in use.
+         *
+         * A source file can also borrow a buffer owned by the caller, in which case nothing is copied. The buffer
+         * must outlive the source file and everything that references it, including any lexemes and schema that
+         * are produced from it, and must not change while it is borrowed.
+         */
+        enum class load_mode { map, read };
+
     private:
         static constexpr const char * memory { "{*MEMORY*}" };
 
         std::string m_file_path;
         std::string m_source;
-        std::size_t m_source_size;
+        std::string_view m_contents;
+        void *m_mapping { nullptr };
+        std::size_t m_mapping_size { 0 };
+        bool m_borrowed { false };
+        mutable std::vector<std::size_t> m_line_starts;
+        mutable std::once_flag m_line_starts_built;
+        std::atomic<std::uint32_t> m_registry_id { 0 };
+
+        friend class file_registry;
+
+        auto map_file() -> bool;
+        auto read_file() -> void;
+        auto line_starts() const -> const std::vector<std::size_t>&;
 
     public:
-        explicit source_file(std::string source, std::string path = source_file::memory);
+        explicit source_file(std::string source, std::string path = source_file::memory, load_mode mode = load_mode::map);
+        source_file(const char *contents, std::size_t length, std::string path = source_file::memory);
+        ~source_file();
+
+        source_file(const source_file&) = delete;
+        auto operator=(const source_file&) -> source_file& = delete;
 
-        [[nodiscard]] auto source() const -> std::string;
+        [[nodiscard]] auto source() const -> std::string_view;
         [[nodiscard]] auto path() const -> std::string;
 
         [[nodiscard]] auto size() const -> std::size_t;
+        [[nodiscard]] auto is_mapped() const -> bool;
+        [[nodiscard]] auto is_borrowed() const -> bool;
+
+        /* Lines are numbered from 1. The offset of the start of each line is indexed the first time that any of
+         * the line accessors are used, after which looking up a line is constant time, and finding the line that
+         * contains an offset is a binary search. Lines do not include their terminating newline.
+         */
+        [[nodiscard]] auto line_count() const -> std::size_t;
+        [[nodiscard]] auto line_start(std::size_t line) const -> std::size_t;
+        [[nodiscard]] auto line_end(std::size_t line) const -> std::size_t;
+        [[nodiscard]] auto line_containing(std::size_t offset) const -> std::size_t;
+        [[nodiscard]] auto source_line(std::size_t line) const -> std::string_view;
 
         [[nodiscard]] auto relative_path(const std::string& rel) const -> std::string;
     };
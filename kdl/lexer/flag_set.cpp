@@ -0,0 +1,75 @@
+// Copyright (c) 2021 Tom Hancocks
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <kdl/lexer/flag_set.hpp>
+
+// MARK: - Construction
+
+kdl::lib::flag_set::flag_set(const std::vector<std::string>& flags)
+{
+    for (const auto& flag : flags) {
+        insert(flag);
+    }
+}
+
+// MARK: - Hashing
+
+auto kdl::lib::flag_set::bucket(std::string_view flag) -> std::uint8_t
+{
+    // FNV-1a, folded down to a single byte.
+    std::uint32_t hash = 2166136261u;
+    for (auto c : flag) {
+        hash = (hash ^ static_cast<std::uint8_t>(c)) * 16777619u;
+    }
+    return static_cast<std::uint8_t>(hash ^ (hash >> 8) ^ (hash >> 16) ^ (hash >> 24));
+}
+
+// MARK: - Flags
+
+auto kdl::lib::flag_set::insert(std::string_view flag) -> void
+{
+    if (contains(flag)) {
+        return;
+    }
+    auto b = bucket(flag);
+    m_buckets.set(b);
+    m_names.emplace_back(flag);
+    m_name_buckets.emplace_back(b);
+}
+
+auto kdl::lib::flag_set::contains(std::string_view flag) const -> bool
+{
+    auto b = bucket(flag);
+    if (!m_buckets.test(b)) {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < m_names.size(); ++i) {
+        if (m_name_buckets[i] == b && m_names[i] == flag) {
+            return true;
+        }
+    }
+    return false;
+}
+
+auto kdl::lib::flag_set::names() const -> const std::vector<std::string>&
+{
+    return m_names;
+}
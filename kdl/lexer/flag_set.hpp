@@ -0,0 +1,54 @@
+// Copyright (c) 2021 Tom Hancocks
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <bitset>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+namespace kdl::lib
+{
+    /* The set of flags that conditional compilation directives (@ifdef and @ifndef) are tested against. Each flag
+     * sets a bit in a bitset according to the hash of its name, so testing for a flag that has not been set is
+     * usually a single bit test. Flags that are set are confirmed by comparing against the name.
+     */
+    class flag_set
+    {
+    public:
+        flag_set() = default;
+        flag_set(const std::vector<std::string>& flags);
+
+        auto insert(std::string_view flag) -> void;
+        [[nodiscard]] auto contains(std::string_view flag) const -> bool;
+        [[nodiscard]] auto names() const -> const std::vector<std::string>&;
+
+    private:
+        static constexpr std::size_t bucket_count { 256 };
+
+        [[nodiscard]] static auto bucket(std::string_view flag) -> std::uint8_t;
+
+        std::bitset<bucket_count> m_buckets;
+        std::vector<std::string> m_names;
+        std::vector<std::uint8_t> m_name_buckets;
+    };
+}
@@ -0,0 +1,108 @@
+// Copyright (c) 2021 Tom Hancocks
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace kdl::lib
+{
+    /* The words that have a special meaning to the parser. Identifiers and directives are tagged with a keyword
+     * when they are constructed, so that the parser can test for a keyword by comparing ids rather than text.
+     * The names below must be kept in the same order as the enumeration.
+     */
+    enum class keyword : std::uint8_t
+    {
+        none,
+        project, module, author, version, copyright, out, import, name_space, use_code_editor,
+        define, declare, component, scene, event, new_, override, duplicate, type, tmpl, function, field, assert_,
+        file, isa, integer, string, color, size, null_terminated, counted, fixed, chr, is_signed, ascii, macroman,
+        utf8, res_edit, posix, kestrel_foundation,
+        count
+    };
+
+    namespace keywords
+    {
+        constexpr std::array<std::string_view, static_cast<std::size_t>(keyword::count)> names {{
+            "",
+            "project", "module", "author", "version", "copyright", "out", "import", "namespace", "use_code_editor",
+            "define", "declare", "component", "scene", "event", "new", "override", "duplicate", "type", "template",
+            "function", "field", "assert", "file", "isa", "integer", "string", "color", "size", "null_terminated",
+            "counted", "fixed", "char", "is_signed", "ascii", "macroman", "utf8", "ResEdit", "POSIX",
+            "KestrelFoundation"
+        }};
+
+        /* The keywords are placed in to a table by a perfect hash, so that any text can be checked with a single
+         * hash and comparison. The seed of the hash is searched for at compile time.
+         */
+        constexpr std::size_t table_size { 256 };
+
+        constexpr auto hash(std::string_view text, std::uint32_t seed) -> std::uint32_t
+        {
+            std::uint32_t h = 2166136261u ^ seed;
+            for (auto c : text) {
+                h = (h ^ static_cast<std::uint8_t>(c)) * 16777619u;
+            }
+            return (h ^ (h >> 15)) & (table_size - 1);
+        }
+
+        constexpr auto find_seed() -> std::uint32_t
+        {
+            for (std::uint32_t seed = 0;; ++seed) {
+                std::array<bool, table_size> used {};
+                bool collision = false;
+                for (std::size_t i = 1; i < names.size() && !collision; ++i) {
+                    auto slot = hash(names[i], seed);
+                    collision = used[slot];
+                    used[slot] = true;
+                }
+                if (!collision) {
+                    return seed;
+                }
+            }
+        }
+
+        constexpr std::uint32_t seed { find_seed() };
+
+        constexpr auto build_table() -> std::array<keyword, table_size>
+        {
+            std::array<keyword, table_size> table {};
+            for (std::size_t i = 1; i < names.size(); ++i) {
+                table[hash(names[i], seed)] = static_cast<keyword>(i);
+            }
+            return table;
+        }
+
+        constexpr std::array<keyword, table_size> table { build_table() };
+    }
+
+    constexpr auto keyword_for(std::string_view text) -> keyword
+    {
+        auto candidate = keywords::table[keywords::hash(text, keywords::seed)];
+        return (keywords::names[static_cast<std::size_t>(candidate)] == text) ? candidate : keyword::none;
+    }
+
+    constexpr auto keyword_name(keyword kw) -> std::string_view
+    {
+        return keywords::names[static_cast<std::size_t>(kw)];
+    }
+}
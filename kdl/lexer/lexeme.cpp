@@ -19,8 +19,11 @@
 // SOFTWARE.
 
 #include <vector>
+#include <algorithm>
 #include <sstream>
 #include <string>
+#include <limits>
+#include <charconv>
 #include <kdl/lexer/lexeme.hpp>
 
 // MARK: - Constructor
@@ -33,19 +36,143 @@ kdl::lib::lexeme::lexeme()
 kdl::lib::lexeme::lexeme(lexeme_type type, const std::string& value)
     : m_type(type), m_value(value)
 {
+    decode_number();
+    decode_keyword();
 }
 
 kdl::lib::lexeme::lexeme(lexeme_type type, kdl::lib::file_reference ref, const std::string& value)
     : m_type(type), m_ref(std::move(ref)), m_value(value)
 {
+    decode_number();
+    decode_keyword();
+}
+
+kdl::lib::lexeme::lexeme(lexeme_type type, kdl::lib::file_reference ref, std::size_t value_offset, std::size_t value_length)
+    : m_type(type), m_ref(std::move(ref)), m_value_offset(value_offset), m_value_length(value_length), m_owns_value(false)
+{
+    decode_string();
+    decode_number();
+    decode_keyword();
+}
+
+// MARK: - Keywords
+
+auto kdl::lib::lexeme::decode_keyword() -> void
+{
+    if (is_keyword_candidate(m_type)) {
+        m_keyword = keyword_for(text());
+    }
+}
+
+auto kdl::lib::lexeme::keyword() const -> lib::keyword
+{
+    return m_keyword;
+}
+
+// MARK: - String Decoding
+
+auto kdl::lib::lexeme::unescape(std::string_view text) -> std::string
+{
+    auto escape = text.find('\\');
+    if (escape == std::string_view::npos) {
+        return std::string(text);
+    }
+
+    // The decoded string is never longer than the source text, so a single allocation is enough.
+    std::string out;
+    out.reserve(text.size());
+    std::size_t start = 0;
+    while (escape != std::string_view::npos) {
+        out.append(text.substr(start, escape - start));
+        if (escape + 1 >= text.size()) {
+            out.push_back('\\');
+            return out;
+        }
+        switch (auto c = text[escape + 1]) {
+            case 'n':   out.push_back('\n'); break;
+            case '"':
+            case '\\':  out.push_back(c); break;
+            default:    out.append(text.substr(escape, 2)); break;
+        }
+        start = escape + 2;
+        escape = text.find('\\', start);
+    }
+    out.append(text.substr(start));
+    return out;
+}
+
+auto kdl::lib::lexeme::decode_string() -> void
+{
+    // Only quoted text is decoded, so that a string referring to the raw contents of a file is left untouched.
+    if (m_type != lexeme_type::string || m_value_offset == 0) {
+        return;
+    }
+
+    auto source = m_ref.file().source();
+    auto text = source.substr(m_value_offset, m_value_length);
+    if (source[m_value_offset - 1] != '"' || text.find('\\') == std::string_view::npos) {
+        return;
+    }
 
+    m_value = unescape(text);
+    m_owns_value = true;
+}
+
+// MARK: - Numeric Decoding
+
+auto kdl::lib::lexeme::decode_number() -> void
+{
+    switch (m_type) {
+        case lexeme_type::integer:
+        case lexeme_type::percentage:
+        case lexeme_type::hex:
+        case lexeme_type::color:
+        case lexeme_type::resource_ref:
+            break;
+        default:
+            return;
+    }
+
+    auto text = this->text();
+    if (m_type == lexeme_type::resource_ref) {
+        // Only the id of a resource reference is numeric, i.e. #TypeName.-128
+        if (auto dot = text.rfind('.'); dot != std::string_view::npos) {
+            text.remove_prefix(dot + 1);
+        }
+    }
+
+    if (!text.empty() && text.front() == '-') {
+        m_number_negative = true;
+        text.remove_prefix(1);
+    }
+
+    const auto base = (m_type == lexeme_type::resource_ref) ? 10 : this->base();
+    if (base == 16 && text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        text.remove_prefix(2);
+    }
+
+    const auto end = text.data() + text.size();
+    auto result = std::from_chars(text.data(), end, m_number, base);
+    if (result.ptr != end || text.empty()) {
+        return;
+    }
+    m_number_overflow = (result.ec == std::errc::result_out_of_range);
+    m_has_number = (result.ec == std::errc()) || m_number_overflow;
 }
 
 // MARK: - Accessors
 
+auto kdl::lib::lexeme::text() const -> std::string_view
+{
+    if (m_owns_value) {
+        return m_value;
+    }
+    return m_ref.file().source().substr(m_value_offset, m_value_length);
+}
+
 auto kdl::lib::lexeme::string_value() const -> std::string
 {
-    return m_value;
+    return std::string(text());
 }
 
 auto kdl::lib::lexeme::is_temporary() const -> bool
@@ -66,36 +193,26 @@ auto kdl::lib::lexeme::type() const -> lexeme_type
 
 // MARK: - Identity Functions
 
-auto kdl::lib::lexeme::is(const std::string& value) const -> bool
+auto kdl::lib::lexeme::is(std::string_view value) const -> bool
 {
-    return m_value == value;
+    return text() == value;
 }
 
 auto kdl::lib::lexeme::is(lexeme_type type) const -> bool
 {
-    if (type == lexeme_type::any_integer) {
-        return (
-            m_type == lexeme_type::integer ||
-            m_type == lexeme_type::percentage ||
-            m_type == lexeme_type::hex ||
-            m_type == lexeme_type::resource_ref
-        );
-    }
-    else if (type == lexeme_type::any_string) {
-        return (
-            m_type == lexeme_type::string
-        );
-    }
-    else {
-        return (m_type == type);
-    }
+    return type_matches(m_type, type);
 }
 
-auto kdl::lib::lexeme::is(lexeme_type type, const std::string& value) const -> bool
+auto kdl::lib::lexeme::is(lexeme_type type, std::string_view value) const -> bool
 {
     return is(type) && is(value);
 }
 
+auto kdl::lib::lexeme::is(lib::keyword kw) const -> bool
+{
+    return is_keyword_candidate(m_type) ? (m_keyword == kw) : is(keyword_name(kw));
+}
+
 auto kdl::lib::lexeme::is_one_of(const std::initializer_list<lexeme_type> &type) const -> bool
 {
     return std::any_of(type.begin(), type.end(), [&] (const auto& it) {
@@ -116,64 +233,123 @@ auto kdl::lib::lexeme::base() const -> uint8_t
     }
 }
 
+auto kdl::lib::lexeme::number_overflowed() const -> bool
+{
+    return m_has_number && m_number_overflow;
+}
+
+auto kdl::lib::lexeme::signed_number() const -> std::optional<int64_t>
+{
+    if (!m_has_number || m_number_overflow || m_type == lexeme_type::resource_ref) {
+        return {};
+    }
+
+    const auto limit = static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+    if (m_number_negative && m_number <= limit + 1) {
+        return static_cast<int64_t>(0 - m_number);
+    }
+    else if (!m_number_negative && m_number <= limit) {
+        return static_cast<int64_t>(m_number);
+    }
+    return {};
+}
+
+auto kdl::lib::lexeme::unsigned_number() const -> std::optional<uint64_t>
+{
+    if (!m_has_number || m_number_overflow || m_type == lexeme_type::resource_ref) {
+        return {};
+    }
+    return m_number_negative ? (0 - m_number) : m_number;
+}
+
 auto kdl::lib::lexeme::int8_value() const -> int8_t
 {
     // TODO: Handle overflow and underflow errors
-    return static_cast<int8_t>(std::stol(m_value, nullptr, base()));
+    if (auto number = signed_number()) {
+        return static_cast<int8_t>(*number);
+    }
+    return static_cast<int8_t>(std::stol(string_value(), nullptr, base()));
 }
 
 auto kdl::lib::lexeme::uint8_value() const -> uint8_t
 {
     // TODO: Handle overflow and underflow errors
-    return static_cast<uint8_t>(std::stoul(m_value, nullptr, base()));
+    if (auto number = unsigned_number()) {
+        return static_cast<uint8_t>(*number);
+    }
+    return static_cast<uint8_t>(std::stoul(string_value(), nullptr, base()));
 }
 
 auto kdl::lib::lexeme::int16_value() const -> int16_t
 {
     // TODO: Handle overflow and underflow errors
-    return static_cast<int16_t>(std::stol(m_value, nullptr, base()));
+    if (auto number = signed_number()) {
+        return static_cast<int16_t>(*number);
+    }
+    return static_cast<int16_t>(std::stol(string_value(), nullptr, base()));
 }
 
 auto kdl::lib::lexeme::uint16_value() const -> uint16_t
 {
     // TODO: Handle overflow and underflow errors
-    return static_cast<uint16_t>(std::stoul(m_value, nullptr, base()));
+    if (auto number = unsigned_number()) {
+        return static_cast<uint16_t>(*number);
+    }
+    return static_cast<uint16_t>(std::stoul(string_value(), nullptr, base()));
 }
 
 auto kdl::lib::lexeme::int32_value() const -> int32_t
 {
     // TODO: Handle overflow and underflow errors
-    return static_cast<int32_t>(std::stol(m_value, nullptr, base()));
+    if (auto number = signed_number()) {
+        return static_cast<int32_t>(*number);
+    }
+    return static_cast<int32_t>(std::stol(string_value(), nullptr, base()));
 }
 
 auto kdl::lib::lexeme::uint32_value() const -> uint32_t
 {
     // TODO: Handle overflow and underflow errors
-    return static_cast<uint32_t>(std::stoul(m_value, nullptr, base()));
+    if (auto number = unsigned_number()) {
+        return static_cast<uint32_t>(*number);
+    }
+    return static_cast<uint32_t>(std::stoul(string_value(), nullptr, base()));
 }
 
 auto kdl::lib::lexeme::int64_value() const -> int64_t
 {
     // TODO: Handle overflow and underflow errors
-    return static_cast<int64_t>(std::stoll(m_value, nullptr, base()));
+    if (auto number = signed_number()) {
+        return static_cast<int64_t>(*number);
+    }
+    return static_cast<int64_t>(std::stoll(string_value(), nullptr, base()));
 }
 
 auto kdl::lib::lexeme::uint64_value() const -> uint64_t
 {
     // TODO: Handle overflow and underflow errors
-    return static_cast<uint64_t>(std::stoull(m_value, nullptr, base()));
+    if (auto number = unsigned_number()) {
+        return static_cast<uint64_t>(*number);
+    }
+    return static_cast<uint64_t>(std::stoull(string_value(), nullptr, base()));
 }
 
 auto kdl::lib::lexeme::double_value() const -> double
 {
     // TODO: Handle overflow and underflow errors
-    return static_cast<double>(std::stod(m_value));
+    if (is_one_of({ lexeme_type::integer, lexeme_type::percentage })) {
+        if (signed_number().has_value()) {
+            auto magnitude = static_cast<double>(m_number);
+            return m_number_negative ? -magnitude : magnitude;
+        }
+    }
+    return static_cast<double>(std::stod(string_value()));
 }
 
 auto kdl::lib::lexeme::long_double_value() const -> long double
 {
     // TODO: Handle overflow and underflow errors
-    return static_cast<long double>(std::stold(m_value));
+    return static_cast<long double>(std::stold(string_value()));
 }
 
 // MARK: - Resource Reference Specific
@@ -192,7 +368,11 @@ static inline auto resource_reference_split(const std::string& ref) -> std::vect
 auto kdl::lib::lexeme::resource_id() const -> int64_t
 {
     if (is(lexeme_type::resource_ref)) {
-        auto components = resource_reference_split(m_value);
+        const auto limit = static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+        if (m_has_number && !m_number_overflow && m_number <= limit + (m_number_negative ? 1 : 0)) {
+            return m_number_negative ? static_cast<int64_t>(0 - m_number) : static_cast<int64_t>(m_number);
+        }
+        auto components = resource_reference_split(string_value());
         return static_cast<int64_t>(std::stoll(components.back()));
     }
     return 0;
@@ -201,7 +381,7 @@ auto kdl::lib::lexeme::resource_id() const -> int64_t
 auto kdl::lib::lexeme::resource_type() const -> std::string
 {
     if (is(lexeme_type::resource_ref)) {
-        auto components = resource_reference_split(m_value);
+        auto components = resource_reference_split(string_value());
         if (components.size() >= 2) {
             return components[components.size() - 2];
         }
@@ -213,5 +393,5 @@ auto kdl::lib::lexeme::resource_type() const -> std::string
 
 auto kdl::lib::lexeme::describe() const -> std::string
 {
-    return m_ref.describe() + " - " + describe_lexeme_type(m_type) + "<" + m_value + ">";
+    return m_ref.describe() + " - " + describe_lexeme_type(m_type) + "<" + string_value() + ">";
 }
\ No newline at end of file
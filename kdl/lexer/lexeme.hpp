@@ -22,10 +22,14 @@
 #define KDL_LEXER_LEXEME_HPP
 
 #include <string>
+#include <string_view>
 #include <memory>
+#include <optional>
+#include <cstdint>
 #include <initializer_list>
 #include <kdl/file/file_reference.hpp>
 #include <kdl/lexer/lexeme_type.hpp>
+#include <kdl/lexer/keyword.hpp>
 
 namespace kdl::lib
 {
@@ -33,30 +37,87 @@ namespace kdl::lib
      * It contains information about the token type, the textual content,
      * location in file and which file, as well as functions for converting
      * the value.
+     *
+     * The textual content of a lexeme produced by the lexer is a slice of the
+     * source file that it references, and is not copied. Only synthesized
+     * values own their text.
+     *
+     * Numeric literals (integers, percentages, hex values, colors and
+     * resource ids) are decoded once when the lexeme is constructed, and the
+     * conversion functions read the decoded value. Text that can not be
+     * decoded, or that overflows, falls back to parsing the text on use.
+     *
+     * String literals support the escapes \", \\ and \n. A string without
+     * any escapes remains a slice of the source, and a string with escapes is
+     * decoded in to an owned value when the lexeme is constructed.
      */
     struct lexeme
     {
     private:
         lexeme_type m_type { lexeme_type::unknown };
         std::string m_value;
-        file_reference m_ref;
+        lib::file_reference m_ref;
+        std::size_t m_value_offset { 0 };
+        std::size_t m_value_length { 0 };
+        bool m_owns_value { true };
+        std::uint64_t m_number { 0 };
+        bool m_number_negative { false };
+        bool m_has_number { false };
+        bool m_number_overflow { false };
+        lib::keyword m_keyword { lib::keyword::none };
+
+        auto decode_number() -> void;
+        auto decode_keyword() -> void;
+        auto decode_string() -> void;
 
     public:
         lexeme();
         explicit lexeme(lexeme_type type, const std::string& value = "");
-        lexeme(lexeme_type type, file_reference ref, const std::string& value = "");
+        lexeme(lexeme_type type, lib::file_reference ref, const std::string& value = "");
+        lexeme(lexeme_type type, lib::file_reference ref, std::size_t value_offset, std::size_t value_length);
 
+        [[nodiscard]] auto text() const -> std::string_view;
         [[nodiscard]] auto string_value() const -> std::string;
         [[nodiscard]] auto is_temporary() const -> bool;
-        [[nodiscard]] auto file_reference() const -> file_reference;
+        [[nodiscard]] auto file_reference() const -> lib::file_reference;
         [[nodiscard]] auto type() const -> lexeme_type;
+        [[nodiscard]] auto keyword() const -> lib::keyword;
+        [[nodiscard]] static constexpr auto is_keyword_candidate(lexeme_type type) -> bool
+        {
+            return (type == lexeme_type::identifier) || (type == lexeme_type::directive);
+        }
+        [[nodiscard]] static auto unescape(std::string_view text) -> std::string;
 
-        [[nodiscard]] auto is(const std::string& value) const -> bool;
+        [[nodiscard]] auto is(std::string_view value) const -> bool;
         [[nodiscard]] auto is(lexeme_type type) const -> bool;
-        [[nodiscard]] auto is(lexeme_type type, const std::string& value) const -> bool;
+        [[nodiscard]] auto is(lexeme_type type, std::string_view value) const -> bool;
+        [[nodiscard]] auto is(lib::keyword kw) const -> bool;
+        [[nodiscard]] static constexpr auto type_matches(lexeme_type type, lexeme_type expected) -> bool
+        {
+            if (expected == lexeme_type::any_integer) {
+                return (
+                    type == lexeme_type::integer ||
+                    type == lexeme_type::percentage ||
+                    type == lexeme_type::hex ||
+                    type == lexeme_type::resource_ref
+                );
+            }
+            else if (expected == lexeme_type::any_string) {
+                return (
+                    type == lexeme_type::string
+                );
+            }
+            else {
+                return (type == expected);
+            }
+        }
+
         [[nodiscard]] auto is_one_of(const std::initializer_list<lexeme_type>& type) const -> bool;
 
         [[nodiscard]] auto base() const -> uint8_t;
+        [[nodiscard]] auto number_overflowed() const -> bool;
+        [[nodiscard]] auto signed_number() const -> std::optional<int64_t>;
+        [[nodiscard]] auto unsigned_number() const -> std::optional<uint64_t>;
 
         [[nodiscard]] auto int8_value() const -> int8_t;
         [[nodiscard]] auto uint8_value() const -> uint8_t;
@@ -95,17 +156,28 @@ namespace kdl::lib
             else if (is_one_of({ lexeme_type::bar })) {
                 return 7;
             }
-            else if (m_value.size() >= 2 && m_value.at(0) == '-' && m_type != lexeme_type::hex) {
-                return static_cast<T>(std::stoll(m_value, nullptr, 10));
+            else if (m_has_number && m_type != lexeme_type::color && m_type != lexeme_type::resource_ref) {
+                if (m_number_negative) {
+                    if (auto number = signed_number()) {
+                        return static_cast<T>(*number);
+                    }
+                }
+                else if (auto number = unsigned_number()) {
+                    return static_cast<T>(*number);
+                }
+            }
+
+            if (text().size() >= 2 && text().at(0) == '-' && m_type != lexeme_type::hex) {
+                return static_cast<T>(std::stoll(string_value(), nullptr, 10));
             }
-            else if (m_value.size() >= 2 && m_value.at(0) == '-' && m_type == lexeme_type::hex) {
-                return static_cast<T>(std::stoll(m_value, nullptr, 16));
+            else if (text().size() >= 2 && text().at(0) == '-' && m_type == lexeme_type::hex) {
+                return static_cast<T>(std::stoll(string_value(), nullptr, 16));
             }
             else if (m_type == lexeme_type::hex) {
-                return static_cast<T>(std::stoull(m_value, nullptr, 16));
+                return static_cast<T>(std::stoull(string_value(), nullptr, 16));
             }
             else {
-                return static_cast<T>(std::stoull(m_value, nullptr, 10));
+                return static_cast<T>(std::stoull(string_value(), nullptr, 10));
             }
         }
 
@@ -21,6 +21,8 @@
 #if !defined(LEXEME_TYPE_HPP)
 #define LEXEME_TYPE_HPP
 
+#include <string>
+
 namespace kdl::lib
 {
     /* Denotes the purpose and intent of a lexical token extracted from a source file.
@@ -90,6 +92,18 @@ namespace kdl::lib
         case lexeme_type::any_string: return "any_string";
         }
     };
+
+    /* The type of lexeme that closes a block opened by the given type, or unknown if the type does not open one.
+     */
+    static constexpr auto closing_delimiter(lexeme_type type) -> lexeme_type
+    {
+        switch (type) {
+        case lexeme_type::lbrace: return lexeme_type::rbrace;
+        case lexeme_type::lparen: return lexeme_type::rparen;
+        case lexeme_type::lbracket: return lexeme_type::rbracket;
+        default: return lexeme_type::unknown;
+        }
+    }
 }
 
 #endif //LEXEME_TYPE_HPP
@@ -18,298 +18,723 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
+#include <thread>
 #include <kdl/lexer/lexer.hpp>
 #include <kdl/lexer/lexical_rules.hpp>
+#include <kdl/lexer/scanner.hpp>
+#include <kdl/lexer/token_cache.hpp>
 #include <kdl/report/reporting.hpp>
 
+namespace kdl::lib
+{
+    /* Files smaller than this are always scanned on the calling thread. Larger files are split in to chunks of at
+     * least the minimum chunk size, which are scanned concurrently.
+     */
+    static constexpr std::size_t parallel_scan_threshold { 1 << 20 };
+    static constexpr std::size_t parallel_scan_min_chunk { 256 << 10 };
+
+    /* Each level of nested conditional block takes a single bit of the lexer state. */
+    static constexpr std::size_t max_condition_depth { 64 };
+
+    /* When scanning in to a token tape, the state of the lexer is recorded roughly this often. */
+    static constexpr std::size_t checkpoint_interval { 4 << 10 };
+
+    /* Thrown in place of reporting an error while speculatively scanning a chunk of a file. The chunk is scanned
+     * again serially, which will report the error if it is genuine.
+     */
+    struct speculation_failure {};
+}
+
 // MARK: - Construction
 
 kdl::lib::lexer::lexer(const std::shared_ptr<source_file>& source)
-    : m_source(source)
+    : m_source(source), m_text(source->source())
 {
 
 }
 
+auto kdl::lib::lexer::set_source(const std::shared_ptr<source_file>& source) -> void
+{
+    m_source = source;
+    m_text = m_source->source();
+    reset();
+}
+
 // MARK: - High Level Scanning
 
 auto kdl::lib::lexer::reset() -> void
 {
     m_lexemes.clear();
-    m_cursor_stack.clear();
+    m_pending.clear();
+    m_previous.reset();
     m_cursor = 0;
     m_line = 1;
     m_line_offset = 0;
+    m_slice_start = 0;
+    m_slice_end = 0;
+    m_expr_paren_balance = 0;
+    m_in_expr = false;
+    m_inactive_conditions = 0;
+    m_condition_depth = 0;
+    m_next_checkpoint = checkpoint_interval;
 }
 
 auto kdl::lib::lexer::scan(bool omit_comments) -> std::vector<lexeme>
 {
+    if (m_text.size() >= parallel_scan_threshold || token_cache::shared().enabled()) {
+        // Large files are scanned in parallel in to a token tape, and then expanded. The token cache also stores
+        // tapes, so when it is enabled the tape is used for files of any size.
+        auto tape = scan_tape(omit_comments);
+        m_lexemes.reserve(tape.size());
+        for (std::size_t i = 0; i < tape.size(); ++i) {
+            m_lexemes.emplace_back(tape.lexeme_at(i));
+        }
+        return m_lexemes;
+    }
+
     reset();
+    m_omit_comments = omit_comments;
 
-    // Open up a new loop and keep iterating until we have no more characters to consume.
+    while (auto lx = next()) {
+        m_lexemes.emplace_back(std::move(*lx));
+    }
+
+    return m_lexemes;
+}
+
+auto kdl::lib::lexer::scan_tape(bool omit_comments) -> token_tape
+{
+    token_tape tape { m_source };
+    scan_tape(tape, omit_comments);
+    return tape;
+}
+
+auto kdl::lib::lexer::scan_tape(token_tape& tape, bool omit_comments) -> void
+{
+    reset();
+    m_omit_comments = omit_comments;
+
+    tape.reset(m_source);
+
+    // An unchanged file that was scanned with the same flags by an earlier build can be taken from the cache.
+    const auto& cache = token_cache::shared();
+    auto cached = cache.enabled();
+    if (cached && cache.load(tape, m_flags, omit_comments)) {
+        restore(tape.checkpoints().back().state);
+        m_line = tape.line_count();
+        return;
+    }
+
+    m_tape = &tape;
+    m_tape->push_checkpoint(state());
+
+    auto boundaries = chunk_boundaries();
+    if (boundaries.size() > 2) {
+        scan_chunks(boundaries);
+    }
     while (has_available()) {
-        consume(lexical_rule::whitespace::contains);
-        mark_lexeme_start();
+        scan_next();
+    }
 
-        // Check for a newline.
-        if (test(lexical_rule::unix_nl::yes)) {
-            advance();
-            m_line++;
-            m_line_offset = 0;
-            continue;
-        }
-        else if (test(lexical_rule::cr::yes)) {
-            advance();
-            continue;
-        }
+    m_tape->push_checkpoint(state());
+    m_tape = nullptr;
 
-        // Check for a comment. Comments consume the remainder of the line that we are on.
-        if (test(lexical_rule::match<'`'>::yes)) {
-            advance();
-            consume(lexical_rule::unix_nl::no);
-            if (!omit_comments) {
-                inject_lexeme(construct_lexeme(lexeme_type::comment));
-            }
-            continue;
-        }
+    if (cached) {
+        cache.store(tape, m_flags, omit_comments);
+    }
+}
 
-        // Directives
-        else if (test(lexical_rule::sequence<'@', 'i', 'f', 'd', 'e', 'f'>::matches, 0, 6)) {
-            advance(6);
-            consume(lexical_rule::whitespace::contains);
-            mark_lexeme_start();
-            consume(lexical_rule::identifier::matches);
-            m_ignore_lexemes = !has_flag(m_consume_slice);
-        }
-        else if (test(lexical_rule::sequence<'@', 'i', 'f', 'n', 'd', 'e', 'f'>::matches, 0, 7)) {
-            advance(7);
-            consume(lexical_rule::whitespace::contains);
-            mark_lexeme_start();
-            consume(lexical_rule::identifier::matches);
-            m_ignore_lexemes = has_flag(m_consume_slice);
-        }
-        else if (test(lexical_rule::sequence<'@', 'e', 'l', 's', 'e'>::matches, 0, 5)) {
-            advance(5);
-            m_ignore_lexemes = !m_ignore_lexemes;
-        }
-        else if (test(lexical_rule::sequence<'@', 'e', 'n', 'd'>::matches, 0, 4)) {
-            advance(4);
-            m_ignore_lexemes = false;
-        }
+auto kdl::lib::lexer::try_scan_tape(bool omit_comments) -> std::optional<token_tape>
+{
+    m_speculative = true;
+    try {
+        auto tape = scan_tape(omit_comments);
+        m_speculative = false;
+        return tape;
+    }
+    catch (const speculation_failure&) {
+        m_speculative = false;
+        m_tape = nullptr;
+        return {};
+    }
+}
 
-        else if (test(lexical_rule::match<'@'>::yes)) {
-            advance();
-            consume(lexical_rule::identifier::matches);
-            inject_lexeme(construct_lexeme(lexeme_type::directive));
-        }
+// MARK: - Incremental Scanning
 
-        // Literals
-        else if (test(lexical_rule::match<'"'>::yes)) {
-            advance();
-            consume(lexical_rule::match<'"'>::no);
-            inject_lexeme(construct_lexeme(lexeme_type::string));
-            advance();
-        }
-        else if (test(lexical_rule::match<'$'>::yes) && !m_in_expr) {
-            advance();
-            if (test(lexical_rule::match<'('>::yes)) {
-                m_in_expr = true;
-                inject_lexeme(construct_lexeme(lexeme_type::lexpr, read()));
+auto kdl::lib::lexer::rescan_tape(const token_tape& previous, const text_edit& edit) -> token_tape
+{
+    // Apply the edit to produce the new source, and switch the lexer over to it.
+    auto previous_text = previous.source()->source();
+    std::string text;
+    text.reserve(previous_text.size() - edit.length + edit.replacement.size());
+    text.append(previous_text.substr(0, edit.offset));
+    text.append(edit.replacement);
+    text.append(previous_text.substr(edit.offset + edit.length));
+
+    // An empty source with a path would be loaded from disk, so an empty result is treated as an in memory source.
+    if (text.empty()) {
+        m_source = std::make_shared<source_file>(std::move(text));
+    }
+    else {
+        m_source = std::make_shared<source_file>(std::move(text), previous.source()->path());
+    }
+    m_text = m_source->source();
+
+    reset();
+    token_tape tape { m_source };
+    m_tape = &tape;
+
+    // Everything up to the last checkpoint before the edit is unaffected by it. The byte at a checkpoint may have
+    // been examined by the lexeme preceding it, so the checkpoint must be strictly before the edit.
+    const auto& checkpoints = previous.checkpoints();
+    std::size_t resume = 0;
+    while (resume + 1 < checkpoints.size() && checkpoints[resume + 1].state.cursor < edit.offset) {
+        ++resume;
+    }
+    tape.append(previous, 0, resume);
+    restore(checkpoints[resume].state);
+
+    // Scan forwards from the checkpoint until the lexer reaches a checkpoint at or beyond the end of the edit, in
+    // the same state as it was previously. Everything after that point is unchanged, other than being shifted.
+    auto shift = static_cast<std::ptrdiff_t>(edit.replacement.size()) - static_cast<std::ptrdiff_t>(edit.length);
+    auto edit_end = edit.offset + edit.replacement.size();
+    auto next = resume + 1;
+
+    while (has_available()) {
+        if (m_cursor >= edit_end) {
+            while (next < checkpoints.size() && checkpoints[next].state.cursor + shift < m_cursor) {
+                ++next;
             }
-            else {
-                consume(lexical_rule::identifier::matches);
-                inject_lexeme(construct_lexeme(lexeme_type::var));
+
+            if (next < checkpoints.size() && checkpoints[next].state.cursor >= edit.offset + edit.length) {
+                auto expected = checkpoints[next].state;
+                expected.cursor += shift;
+                if (expected == state()) {
+                    tape.append(previous, next, checkpoints.size() - 1, shift);
+                    auto end = checkpoints.back().state;
+                    end.cursor += shift;
+                    restore(end);
+                    break;
+                }
             }
         }
-        else if (test(lexical_rule::match<')'>::yes) && m_in_expr && m_expr_paren_balance == 0) {
-            m_in_expr = false;
-            inject_lexeme(construct_lexeme(lexeme_type::rexpr, read()));
-        }
-        else if (test(lexical_rule::sequence<'c', '#'>::matches, 0, 2) && test(lexical_rule::numeric::hexadecimal::matches, 2, 8)) {
-            advance(2);
-            inject_lexeme(construct_lexeme(lexeme_type::color, read(8)));
-        }
-        else if (test(lexical_rule::match<'#'>::yes)) {
-            advance();
+        scan_next();
+    }
 
-            std::string reference;
+    m_tape->push_checkpoint(state());
+    m_tape = nullptr;
+    return tape;
+}
 
-            // Check if we have an identifier leading the id itself
-            // i.e.  #TypeName.000
-            if (test(lexical_rule::identifier::matches)) {
-                consume(lexical_rule::identifier::matches);
-                reference += m_consume_slice;
+// MARK: - Parallel Scanning
 
-                while (test(lexical_rule::sequence<':', ':'>::matches, 0, 2)) {
-                    advance(2);
-                    consume(lexical_rule::identifier::matches);
-                    reference += "::" + m_consume_slice;
-                }
+auto kdl::lib::lexer::chunk_boundaries() const -> std::vector<std::size_t>
+{
+    std::vector<std::size_t> boundaries { 0 };
 
-                if (test(lexical_rule::match<'.'>::no)) {
-                    report::error(m_lexemes.back(), "Expected '.' after resource type name.");
-                }
+    auto threads = static_cast<std::size_t>(std::thread::hardware_concurrency());
+    auto chunks = std::min(threads, m_text.size() / parallel_scan_min_chunk);
+    if (m_text.size() < parallel_scan_threshold || chunks < 2) {
+        boundaries.emplace_back(m_text.size());
+        return boundaries;
+    }
 
-                advance();
-                reference += ".";
-            }
+    // Each chunk ends immediately after a newline, so that every chunk begins at the start of a line.
+    auto chunk_size = m_text.size() / chunks;
+    for (std::size_t n = 1; n < chunks; ++n) {
+        auto newline = m_text.find('\n', std::max(n * chunk_size, boundaries.back()));
+        if (newline == std::string_view::npos) {
+            break;
+        }
+        boundaries.emplace_back(newline + 1);
+    }
+
+    if (boundaries.back() < m_text.size()) {
+        boundaries.emplace_back(m_text.size());
+    }
+    return boundaries;
+}
 
-            auto negative = test(lexical_rule::match<'-'>::yes);
-            if (negative) {
-                advance();
+auto kdl::lib::lexer::scan_chunks(const std::vector<std::size_t>& boundaries) -> void
+{
+    // Each chunk is scanned speculatively, on the assumption that it begins at the start of a line with the lexer
+    // in its default state. The final checkpoint of each chunk's tape marks the end of the chunk, unless the worker
+    // encountered an error.
+    std::vector<token_tape> chunks;
+    chunks.reserve(boundaries.size() - 1);
+    for (std::size_t n = 0; n < boundaries.size() - 1; ++n) {
+        chunks.emplace_back(m_source);
+    }
+
+    std::vector<std::thread> workers;
+    for (std::size_t n = 0; n < chunks.size(); ++n) {
+        workers.emplace_back([&, n] {
+            lexer worker { m_source };
+            worker.m_flags = m_flags;
+            worker.m_omit_comments = m_omit_comments;
+            worker.m_speculative = true;
+            worker.m_tape = &chunks[n];
+            worker.m_cursor = boundaries[n];
+            worker.m_next_checkpoint = boundaries[n] + checkpoint_interval;
+            worker.m_tape->push_checkpoint(worker.state());
+
+            try {
+                while (worker.m_cursor < boundaries[n + 1] && worker.has_available()) {
+                    worker.scan_next();
+                }
+                worker.m_tape->push_checkpoint(worker.state());
             }
+            catch (const speculation_failure&) {
+                // Everything up to the last checkpoint remains usable.
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
 
-            consume(lexical_rule::numeric::decimal::contains);
-            if (negative) {
-                m_consume_slice.insert(0, 1, '-');
+    // Stitch the chunks together. The lexer scans serially until it reaches one of a chunk's checkpoints in exactly
+    // the state that the worker recorded, from which point the worker's output is known to be correct and can be
+    // used up to its final checkpoint. Usually this is the very first checkpoint at the start of the chunk, but if
+    // a string literal, expression or conditional block spans the boundary then it is further in.
+    for (std::size_t n = 0; n < chunks.size(); ++n) {
+        const auto& checkpoints = chunks[n].checkpoints();
+        std::size_t i = 0;
+
+        while (m_cursor < boundaries[n + 1] && has_available()) {
+            while (i < checkpoints.size() && checkpoints[i].state.cursor < m_cursor) {
+                ++i;
             }
-            m_consume_slice = reference + m_consume_slice;
 
-            inject_lexeme(construct_lexeme(lexeme_type::resource_ref));
-        }
-        else if (test(lexical_rule::numeric::decimal::contains)) {
-            lexeme_type number_type = lexeme_type::integer;
-            if (peek(2) == "0x" || peek(2) == "0X") {
-                // Hexadecimal
-                advance(2);
-                consume(lexical_rule::numeric::hexadecimal::contains);
-                number_type = lexeme_type::hex;
+            if (i < checkpoints.size() && checkpoints[i].state == state()) {
+                m_tape->append(chunks[n], i, checkpoints.size() - 1);
+                restore(checkpoints.back().state);
+                i = checkpoints.size();
             }
             else {
-                auto negative = test(lexical_rule::match<'-'>::yes);
-                if (negative) {
-                    advance();
-                }
+                scan_next();
+            }
+        }
+    }
+}
 
-                consume(lexical_rule::numeric::decimal::contains);
-                if (negative) {
-                    m_consume_slice.insert(0, 1, '-');
-                }
+auto kdl::lib::lexer::state() const -> lexer_state
+{
+    return { m_cursor, m_line_offset, m_expr_paren_balance, m_in_expr, m_inactive_conditions, m_condition_depth };
+}
 
-                if (test(lexical_rule::match<'%'>::yes)) {
-                    number_type = lexeme_type::percentage;
-                    advance();
-                }
-            }
+auto kdl::lib::lexer::restore(const lexer_state& state) -> void
+{
+    // When resuming in to a token tape, the line number is implied by the lines that have been recorded.
+    if (m_tape) {
+        m_line = m_tape->line_count();
+    }
+    m_next_checkpoint = state.cursor + checkpoint_interval;
+    m_cursor = state.cursor;
+    m_line_offset = state.line_offset;
+    m_expr_paren_balance = state.expr_paren_balance;
+    m_in_expr = state.in_expr;
+    m_inactive_conditions = state.inactive_conditions;
+    m_condition_depth = state.condition_depth;
+}
 
-            inject_lexeme(construct_lexeme(number_type));
-        }
-        else if (test(lexical_rule::identifier::limited_set::contains)) {
-            consume(lexical_rule::identifier::set::contains);
-            inject_lexeme(construct_lexeme(lexeme_type::identifier));
-        }
+auto kdl::lib::lexer::next() -> std::optional<lexeme>
+{
+    // Keep scanning until at least one lexeme has been produced, or the end of the source has been reached. Some
+    // constructs (such as comments when they are being omitted) do not produce any lexemes.
+    while (m_pending.empty() && has_available()) {
+        scan_next();
+    }
 
-        // Operators
-        else if (test(lexical_rule::sequence<':', ':'>::matches, 0, 2)) {
-            inject_lexeme(construct_lexeme(lexeme_type::scope, read(2)));
-        }
-        else if (test(lexical_rule::sequence<'<', '<'>::matches, 0, 2)) {
-            inject_lexeme(construct_lexeme(lexeme_type::shift_left, read(2)));
-        }
-        else if (test(lexical_rule::sequence<'>', '>'>::matches, 0, 2)) {
-            inject_lexeme(construct_lexeme(lexeme_type::shift_right, read(2)));
-        }
-        else if (test(lexical_rule::match<';'>::yes)) {
-            inject_lexeme(construct_lexeme(lexeme_type::semicolon, read()));
-        }
-        else if (test(lexical_rule::match<':'>::yes)) {
-            inject_lexeme(construct_lexeme(lexeme_type::colon, read()));
+    if (m_pending.empty()) {
+        return {};
+    }
+
+    m_previous = std::move(m_pending.front());
+    m_pending.pop_front();
+    return m_previous;
+}
+
+auto kdl::lib::lexer::scan_next() -> void
+{
+    if (is_inactive()) {
+        skip_inactive();
+    }
+    else {
+        scan_lexeme();
+    }
+
+    if (m_tape && m_cursor >= m_next_checkpoint) {
+        m_tape->push_checkpoint(state());
+        m_next_checkpoint = m_cursor + checkpoint_interval;
+    }
+}
+
+auto kdl::lib::lexer::skip_inactive() -> void
+{
+    // Nothing inside an inactive conditional block is tokenized. The only things that matter are the directives
+    // that might end the block, newlines for line numbering, and the strings and comments that could hide a '@'.
+    const auto begin = m_text.data() + m_cursor;
+    const auto stop = scanner::find_any(begin, m_text.data() + m_text.size(), '\n', '"', '`', '@');
+    advance(static_cast<std::size_t>(stop - begin));
+    mark_lexeme_start();
+
+    if (!has_available()) {
+        return;
+    }
+
+    switch (peek()) {
+        case '\n': {
+            scan_newline();
+            break;
         }
-        else if (test(lexical_rule::match<'*'>::yes)) {
-            inject_lexeme(construct_lexeme(lexeme_type::star, read()));
+        case '`': {
+            advance();
+            begin_slice();
+            consume_until('\n');
+            break;
         }
-        else if (test(lexical_rule::match<'+'>::yes)) {
-            inject_lexeme(construct_lexeme(lexeme_type::plus, read()));
+        case '"': {
+            consume_string();
+            advance();
+            break;
         }
-        else if (test(lexical_rule::match<'-'>::yes)) {
-            inject_lexeme(construct_lexeme(lexeme_type::minus, read()));
+        default: {
+            scan_directive();
+            break;
         }
-        else if (test(lexical_rule::match<'='>::yes)) {
-            inject_lexeme(construct_lexeme(lexeme_type::equals, read()));
+    }
+}
+
+auto kdl::lib::lexer::scan_lexeme() -> void
+{
+    // Each step looks at a single character and dispatches to the rule that handles it.
+    consume(lexical_rule::whitespace);
+    mark_lexeme_start();
+
+    if (!has_available()) {
+        return;
+    }
+
+    const auto c = peek();
+    switch (c) {
+        // Check for a newline.
+        case '\n': {
+            scan_newline();
+            break;
         }
-        else if (test(lexical_rule::match<'!'>::yes)) {
-            inject_lexeme(construct_lexeme(lexeme_type::exclaim, read()));
+        case '\r': {
+            advance();
+            break;
         }
-        else if (test(lexical_rule::match<'?'>::yes)) {
-            inject_lexeme(construct_lexeme(lexeme_type::question, read()));
+
+        // Check for a comment. Comments consume the remainder of the line that we are on.
+        case '`': {
+            advance();
+            begin_slice();
+            consume_until('\n');
+            if (!m_omit_comments) {
+                emit(lexeme_type::comment);
+            }
+            break;
         }
-        else if (test(lexical_rule::match<'^'>::yes)) {
-            inject_lexeme(construct_lexeme(lexeme_type::carat, read()));
+
+        // Directives
+        case '@': {
+            scan_directive();
+            break;
         }
-        else if (test(lexical_rule::match<'&'>::yes)) {
-            inject_lexeme(construct_lexeme(lexeme_type::amp, read()));
+
+        // Literals
+        case '"': {
+            consume_string();
+            emit(lexeme_type::string);
+            advance();
+            break;
         }
-        else if (test(lexical_rule::match<'('>::yes)) {
-            inject_lexeme(construct_lexeme(lexeme_type::lparen, read()));
+        case '$': {
             if (m_in_expr) {
-                m_expr_paren_balance++;
+                error("Unexpected character encountered: '$'");
             }
-        }
-        else if (test(lexical_rule::match<')'>::yes)) {
-            inject_lexeme(construct_lexeme(lexeme_type::rparen, read()));
-            if (m_in_expr) {
-                m_expr_paren_balance--;
+            advance();
+            if (test('(')) {
+                m_in_expr = true;
+                emit_next(lexeme_type::lexpr);
+            }
+            else {
+                begin_slice();
+                consume_identifier();
+                emit(lexeme_type::var);
             }
+            break;
         }
-        else if (test(lexical_rule::match<'['>::yes)) {
-            inject_lexeme(construct_lexeme(lexeme_type::lbracket, read()));
+        case '#': {
+            scan_resource_reference();
+            break;
         }
-        else if (test(lexical_rule::match<']'>::yes)) {
-            inject_lexeme(construct_lexeme(lexeme_type::rbracket, read()));
+
+        // Operators that need more than a single character of context.
+        case ':': {
+            test("::") ? emit_next(lexeme_type::scope, 2) : emit_next(lexeme_type::colon);
+            break;
         }
-        else if (test(lexical_rule::match<'<'>::yes)) {
-            inject_lexeme(construct_lexeme(lexeme_type::langle, read()));
+        case '<': {
+            test("<<") ? emit_next(lexeme_type::shift_left, 2) : emit_next(lexeme_type::langle);
+            break;
         }
-        else if (test(lexical_rule::match<'>'>::yes)) {
-            inject_lexeme(construct_lexeme(lexeme_type::rangle, read()));
+        case '>': {
+            test(">>") ? emit_next(lexeme_type::shift_right, 2) : emit_next(lexeme_type::rangle);
+            break;
         }
-        else if (test(lexical_rule::match<'{'>::yes)) {
-            inject_lexeme(construct_lexeme(lexeme_type::lbrace, read()));
+        case '(': {
+            emit_next(lexeme_type::lparen);
+            if (m_in_expr) {
+                m_expr_paren_balance++;
+            }
+            break;
         }
-        else if (test(lexical_rule::match<'}'>::yes)) {
-            inject_lexeme(construct_lexeme(lexeme_type::rbrace, read()));
+        case ')': {
+            if (m_in_expr && m_expr_paren_balance == 0) {
+                m_in_expr = false;
+                emit_next(lexeme_type::rexpr);
+            }
+            else {
+                emit_next(lexeme_type::rparen);
+                if (m_in_expr) {
+                    m_expr_paren_balance--;
+                }
+            }
+            break;
         }
-        else if (test(lexical_rule::match<'.'>::yes)) {
-            inject_lexeme(construct_lexeme(lexeme_type::dot, read()));
+        case 'c': {
+            if (test_color()) {
+                advance(2);
+                emit_next(lexeme_type::color, 8);
+                break;
+            }
+            [[fallthrough]];
         }
-        else if (test(lexical_rule::match<','>::yes)) {
-            inject_lexeme(construct_lexeme(lexeme_type::comma, read()));
+
+        default: {
+            if (lexical_rule::is(c, lexical_rule::decimal)) {
+                scan_number();
+            }
+            else if (lexical_rule::is(c, lexical_rule::identifier_head)) {
+                begin_slice();
+                consume(lexical_rule::identifier);
+                emit(lexeme_type::identifier);
+            }
+            else if (auto type = lexical_rule::punctuation_type(c); type != lexeme_type::unknown) {
+                emit_next(type);
+            }
+            else {
+                error("Unexpected character encountered: '" + std::string(1, c) + "'");
+            }
+            break;
         }
-        else if (test(lexical_rule::match<'|'>::yes)) {
-            inject_lexeme(construct_lexeme(lexeme_type::bar, read()));
+    }
+}
+
+// MARK: - Iteration
+
+kdl::lib::lexer::iterator::iterator(lexer *lexer)
+    : m_lexer(lexer), m_current(lexer->next())
+{
+    if (!m_current.has_value()) {
+        m_lexer = nullptr;
+    }
+}
+
+auto kdl::lib::lexer::iterator::operator*() const -> reference
+{
+    return *m_current;
+}
+
+auto kdl::lib::lexer::iterator::operator->() const -> pointer
+{
+    return &(*m_current);
+}
+
+auto kdl::lib::lexer::iterator::operator++() -> iterator&
+{
+    m_current = m_lexer->next();
+    if (!m_current.has_value()) {
+        m_lexer = nullptr;
+    }
+    return *this;
+}
+
+auto kdl::lib::lexer::iterator::operator==(const iterator& other) const -> bool
+{
+    return m_lexer == other.m_lexer;
+}
+
+auto kdl::lib::lexer::iterator::operator!=(const iterator& other) const -> bool
+{
+    return m_lexer != other.m_lexer;
+}
+
+auto kdl::lib::lexer::begin() -> iterator
+{
+    return iterator(this);
+}
+
+auto kdl::lib::lexer::end() -> iterator
+{
+    return {};
+}
+
+// MARK: - Rules
+
+auto kdl::lib::lexer::scan_newline() -> void
+{
+    advance();
+    m_line++;
+    m_line_offset = 0;
+    if (m_tape) {
+        m_tape->push_line(m_cursor);
+    }
+}
+
+auto kdl::lib::lexer::scan_directive() -> void
+{
+    advance();
+    begin_slice();
+    consume_identifier();
+    const auto name = slice();
+
+    if (name == "ifdef" || name == "ifndef") {
+        consume(lexical_rule::whitespace);
+        begin_slice();
+        consume_identifier();
+        const auto defined = m_flags.contains(slice());
+        push_condition((name == "ifdef") == defined);
+    }
+    else if (name == "else") {
+        if (m_condition_depth == 0) {
+            error("Encountered '@else' outside of a conditional block.");
         }
-        else if (test(lexical_rule::match<'\\'>::yes)) {
-            inject_lexeme(construct_lexeme(lexeme_type::backslash, read()));
+        m_inactive_conditions ^= (std::uint64_t(1) << (m_condition_depth - 1));
+    }
+    else if (name == "end") {
+        if (m_condition_depth == 0) {
+            error("Encountered '@end' outside of a conditional block.");
         }
-        else if (test(lexical_rule::match<'~'>::yes)) {
-            inject_lexeme(construct_lexeme(lexeme_type::tilde, read()));
+        m_condition_depth--;
+        m_inactive_conditions &= ~(std::uint64_t(1) << m_condition_depth);
+    }
+    else {
+        emit(lexeme_type::directive);
+    }
+}
+
+auto kdl::lib::lexer::push_condition(bool active) -> void
+{
+    if (m_condition_depth == max_condition_depth) {
+        error("Conditional blocks are nested too deeply.");
+    }
+    if (!active) {
+        m_inactive_conditions |= (std::uint64_t(1) << m_condition_depth);
+    }
+    m_condition_depth++;
+}
+
+auto kdl::lib::lexer::is_inactive() const -> bool
+{
+    // A block is only active if every block that encloses it is also active.
+    return m_inactive_conditions != 0;
+}
+
+auto kdl::lib::lexer::scan_resource_reference() -> void
+{
+    advance();
+    begin_slice();
+
+    // Check if we have an identifier leading the id itself
+    // i.e.  #TypeName.000
+    if (test_class(lexical_rule::identifier_head)) {
+        consume_identifier();
+        while (test("::")) {
+            advance(2);
+            consume_identifier();
         }
-        else if (test(lexical_rule::match<'/'>::yes)) {
-            inject_lexeme(construct_lexeme(lexeme_type::slash, read()));
+
+        if (!test('.')) {
+            error("Expected '.' after resource type name.");
         }
+        advance();
+    }
+
+    if (test('-')) {
+        advance();
+    }
+    consume(lexical_rule::decimal);
 
-        else {
-            report::error(m_lexemes.back(), "Unexpected character encountered: '" + peek() + "'");
+    emit(lexeme_type::resource_ref);
+}
+
+auto kdl::lib::lexer::scan_number() -> void
+{
+    auto number_type = lexeme_type::integer;
+    if (test("0x") || test("0X")) {
+        // Hexadecimal
+        advance(2);
+        begin_slice();
+        consume(lexical_rule::hexadecimal);
+        number_type = lexeme_type::hex;
+    }
+    else {
+        begin_slice();
+        consume(lexical_rule::decimal);
+        if (test('%')) {
+            number_type = lexeme_type::percentage;
+            advance();
         }
     }
 
-    return m_lexemes;
+    emit(number_type);
+}
+
+auto kdl::lib::lexer::test_color() const -> bool
+{
+    if (!test("c#") || !has_available(2, 8)) {
+        return false;
+    }
+
+    // The 8 characters following the 'c#' must be hexadecimal, although a leading '0x' is permitted.
+    std::size_t offset = 2;
+    if (test('0', offset) && (test('x', offset + 1) || test('X', offset + 1))) {
+        offset += 2;
+    }
+    for (; offset < 10; ++offset) {
+        if (!test_class(lexical_rule::hexadecimal, offset)) {
+            return false;
+        }
+    }
+    return true;
 }
 
 // MARK: - Flags
 
+auto kdl::lib::lexer::set_omit_comments(bool omit_comments) -> void
+{
+    m_omit_comments = omit_comments;
+}
+
 auto kdl::lib::lexer::set_flags(const std::vector<std::string>& flags) -> void
 {
-    m_flags = flags;
+    m_flags = flag_set(flags);
 }
 
 auto kdl::lib::lexer::add_flag(const std::string& flag) -> void
 {
-    m_flags.emplace_back(flag);
+    m_flags.insert(flag);
 }
 
 auto kdl::lib::lexer::has_flag(const std::string& flag) const -> bool
 {
-    return (std::find(m_flags.begin(), m_flags.end(), flag) != m_flags.end());
+    return m_flags.contains(flag);
 }
 
 // MARK: - Basic Accessors
@@ -334,104 +759,132 @@ auto kdl::lib::lexer::offset() const -> std::size_t
     return m_line_offset;
 }
 
-auto kdl::lib::lexer::lexemes() const -> std::vector<lexeme>
+auto kdl::lib::lexer::lexemes() const -> const std::vector<lexeme>&
 {
     return m_lexemes;
 }
 
 // MARK: - Cursor Functions
 
-auto kdl::lib::lexer::save_cursor() -> void
+auto kdl::lib::lexer::advance(std::size_t count) -> void
 {
-    m_cursor_stack.emplace_back(m_cursor);
+    m_cursor += count;
+    m_line_offset += count;
 }
 
-auto kdl::lib::lexer::restore_cursor() -> void
+auto kdl::lib::lexer::has_available(std::size_t offset, std::size_t count) const -> bool
 {
-    if (m_cursor_stack.empty()) {
-        report::error("Lexer attempted to restore to a position that did not exist.");
-    }
-    m_cursor = m_cursor_stack.back();
-    m_cursor_stack.pop_back();
+    return (m_cursor + offset + count) <= m_text.size();
 }
 
-auto kdl::lib::lexer::detached_cursor(const std::function<auto(lexer&)->bool>& ctx) -> void
+auto kdl::lib::lexer::peek(std::size_t offset) const -> char
 {
-    save_cursor();
-    if (ctx(*this)) {
-        restore_cursor();
-    }
+    return has_available(offset) ? m_text[m_cursor + offset] : '\0';
 }
 
-auto kdl::lib::lexer::advance(std::int32_t offset) -> void
+// MARK: - Test Functions
+
+auto kdl::lib::lexer::test(char c, std::size_t offset) const -> bool
 {
-    m_cursor += offset;
-    m_line_offset += offset;
+    return has_available(offset) && m_text[m_cursor + offset] == c;
 }
 
-auto kdl::lib::lexer::has_available(std::int32_t offset, std::size_t count) const -> bool
+auto kdl::lib::lexer::test(std::string_view sequence, std::size_t offset) const -> bool
 {
-    return (m_cursor + offset + count) <= (m_source->size());
+    return has_available(offset, sequence.size()) && m_text.compare(m_cursor + offset, sequence.size(), sequence) == 0;
 }
 
-auto kdl::lib::lexer::peek(std::size_t count, std::int32_t offset) const -> std::string
+auto kdl::lib::lexer::test_class(std::uint8_t char_class, std::size_t offset) const -> bool
 {
-    if (!has_available(offset, count)) {
-        report::error(m_lexemes.back(), "Failed to read string from source.");
-    }
-    return m_source->source().substr(m_cursor + offset, count);
+    return has_available(offset) && lexical_rule::is(m_text[m_cursor + offset], char_class);
 }
 
-auto kdl::lib::lexer::read(std::size_t count, std::int32_t offset) -> std::string
+// MARK: - Consume Functions
+
+auto kdl::lib::lexer::begin_slice() -> void
 {
-    auto str = peek(count, offset);
-    advance(static_cast<std::int32_t>(offset + count));
-    return str;
+    m_slice_start = m_slice_end = m_cursor;
 }
 
-// MARK: - Test Function
-
-auto kdl::lib::lexer::test(const std::function<auto(const std::string&)->bool>& fn, std::int32_t offset, std::size_t count) const -> bool
+auto kdl::lib::lexer::consume(std::uint8_t char_class) -> bool
 {
-    if (!has_available(offset, count)) {
-        return false;
+    // Whitespace and identifiers form the longest runs in most source files, and are handed to the bulk scanning
+    // kernels. Everything else is short enough to test a byte at a time.
+    const auto begin = m_text.data() + m_cursor;
+    const auto end = m_text.data() + m_text.size();
+    const char *stop;
+
+    if (char_class == lexical_rule::whitespace) {
+        stop = scanner::skip_whitespace(begin, end);
     }
-    return fn(peek(count, offset));
+    else if (char_class == lexical_rule::identifier) {
+        stop = scanner::skip_identifier(begin, end);
+    }
+    else {
+        stop = begin;
+        while (stop < end && lexical_rule::is(*stop, char_class)) {
+            ++stop;
+        }
+    }
+
+    advance(static_cast<std::size_t>(stop - begin));
+    m_slice_end = m_cursor;
+    return m_slice_end > m_slice_start;
 }
 
-auto kdl::lib::lexer::test(const std::function<auto(std::size_t, const std::string&)->bool>& fn, std::int32_t offset, std::size_t count) const -> bool
+auto kdl::lib::lexer::consume_identifier() -> bool
 {
-    if (!has_available(offset, count)) {
+    if (!test_class(lexical_rule::identifier_head)) {
+        m_slice_end = m_cursor;
         return false;
     }
-    return fn(0, peek(count, offset));
+    return consume(lexical_rule::identifier);
 }
 
-auto kdl::lib::lexer::consume(const std::function<auto(const std::string&)->bool>& fn, std::size_t count) -> bool
+auto kdl::lib::lexer::consume_until(char c) -> bool
 {
-    m_consume_slice.clear();
-    while (fn(peek(count))) {
-        m_consume_slice += read(count);
-    }
-    return !m_consume_slice.empty();
+    const auto begin = m_text.data() + m_cursor;
+    const auto stop = scanner::find(begin, m_text.data() + m_text.size(), c);
+    advance(static_cast<std::size_t>(stop - begin));
+    m_slice_end = m_cursor;
+    return m_slice_end > m_slice_start;
 }
 
-auto kdl::lib::lexer::consume(const std::function<auto(std::size_t, const std::string&)->bool>& fn, std::size_t count) -> bool
+auto kdl::lib::lexer::consume_string() -> void
 {
-    std::size_t pos = 0;
-    m_consume_slice.clear();
-    while (fn(pos, peek(count))) {
-        pos += count;
-        m_consume_slice += read(count);
+    // Consume the body of a string literal, leaving the cursor on its closing quote. The body is searched for the
+    // closing quote and for escapes together, and each escape is stepped over so that an escaped quote does not end
+    // the string. Escapes are decoded when the lexeme is constructed.
+    advance();
+    begin_slice();
+
+    const auto end = m_text.data() + m_text.size();
+    while (true) {
+        const auto begin = m_text.data() + m_cursor;
+        const auto stop = scanner::find_any(begin, end, '"', '\\', '"', '\\');
+        advance(static_cast<std::size_t>(stop - begin));
+        if (has_available() && peek() == '"') {
+            break;
+        }
+        if (!has_available(0, 2)) {
+            error("Failed to read string from source.");
+        }
+        advance(2);
     }
-    return !m_consume_slice.empty();
+    m_slice_end = m_cursor;
+}
+
+auto kdl::lib::lexer::slice() const -> std::string_view
+{
+    return m_text.substr(m_slice_start, m_slice_end - m_slice_start);
 }
 
 // MARK: - File References
 
 auto kdl::lib::lexer::generate_file_reference() const -> file_reference
 {
-    return { m_source, m_cursor, m_line, m_marker, m_line_offset - m_marker };
+    auto length = m_line_offset - m_marker;
+    return { m_source, m_cursor - length, length };
 }
 
 // MARK: - Lexeme Construction
@@ -443,18 +896,47 @@ auto kdl::lib::lexer::mark_lexeme_start() -> void
 
 auto kdl::lib::lexer::construct_lexeme(lexeme_type type) const -> lexeme
 {
-    return { type, generate_file_reference(), m_consume_slice };
+    return { type, generate_file_reference(), m_slice_start, m_slice_end - m_slice_start };
 }
 
-auto kdl::lib::lexer::construct_lexeme(kdl::lib::lexeme_type type, const std::string& value) const -> kdl::lib::lexeme
+auto kdl::lib::lexer::emit(lexeme_type type) -> void
 {
-    return { type, generate_file_reference(), value };
+    if (is_inactive()) {
+        return;
+    }
+
+    if (m_tape) {
+        auto length = m_line_offset - m_marker;
+        m_tape->push(type, m_cursor - length, length);
+    }
+    else {
+        m_pending.emplace_back(construct_lexeme(type));
+    }
 }
 
-auto kdl::lib::lexer::inject_lexeme(lexeme lx) -> void
+auto kdl::lib::lexer::emit_next(lexeme_type type, std::size_t count) -> void
 {
-    if (m_ignore_lexemes) {
-        return;
+    begin_slice();
+    advance(count);
+    m_slice_end = m_cursor;
+    emit(type);
+}
+
+auto kdl::lib::lexer::error(const std::string& message) const -> void
+{
+    if (m_speculative) {
+        throw speculation_failure();
+    }
+
+    // Errors are reported against the most recently produced lexeme, if there is one.
+    if (m_tape && !m_tape->empty()) {
+        report::error(m_tape->lexeme_at(m_tape->size() - 1), message);
+    }
+    else if (!m_pending.empty()) {
+        report::error(m_pending.back(), message);
+    }
+    else if (m_previous.has_value()) {
+        report::error(*m_previous, message);
     }
-    m_lexemes.emplace_back(std::move(lx));
+    report::error(construct_lexeme(lexeme_type::unknown), message);
 }
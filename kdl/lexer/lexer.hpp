@@ -21,69 +21,162 @@
 #pragma once
 
 #include <vector>
+#include <deque>
+#include <optional>
+#include <iterator>
 #include <string>
+#include <string_view>
 #include <memory>
-#include <functional>
 #include <kdl/file/source_file.hpp>
 #include <kdl/file/file_reference.hpp>
 #include <kdl/lexer/lexeme.hpp>
+#include <kdl/lexer/token_tape.hpp>
+#include <kdl/lexer/lexer_state.hpp>
+#include <kdl/lexer/flag_set.hpp>
 
 namespace kdl::lib
 {
+    /* An edit to a source file, replacing length bytes at offset with the replacement text. */
+    struct text_edit
+    {
+        std::size_t offset { 0 };
+        std::size_t length { 0 };
+        std::string replacement;
+    };
 
+    /* The lexer can either scan an entire source file up front, producing a vector of lexemes, or produce lexemes
+     * on demand through next() (or by iterating over the lexer). When lexemes are produced on demand, only a small
+     * window of lexemes is held by the lexer at any one time. Alternatively the lexemes can be recorded in to a
+     * compact token tape.
+     *
+     * Large files are split at line boundaries and the chunks are scanned concurrently when scanning up front.
+     * try_scan_tape() does not report errors, and instead produces no tape if the source could not be scanned.
+     *
+     * Tapes are taken from the token cache when it is enabled, and stored in to it after scanning.
+     *
+     * A lexer can be pointed at a new source with set_source(), and can scan in to an existing token tape, so that
+     * the buffers of both are reused when the same lexer is used to scan many sources.
+     *
+     * A token tape can be brought up to date after an edit to its source with rescan_tape(), which only scans the
+     * region affected by the edit. The lexer switches to the edited source, so that further edits can be applied.
+     * The same flags and comment handling as the original scan are used.
+     *
+     * Conditional blocks (@ifdef, @ifndef, @else and @end) may be nested. The body of an inactive block is skipped
+     * without being tokenized, stopping only at newlines, strings, comments and directives.
+     */
     class lexer
     {
+    public:
+        class iterator
+        {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = lexeme;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const lexeme *;
+            using reference = const lexeme&;
+
+            iterator() = default;
+            explicit iterator(lexer *lexer);
+
+            auto operator*() const -> reference;
+            auto operator->() const -> pointer;
+            auto operator++() -> iterator&;
+            auto operator==(const iterator& other) const -> bool;
+            auto operator!=(const iterator& other) const -> bool;
+
+        private:
+            lexer *m_lexer { nullptr };
+            std::optional<lexeme> m_current;
+        };
+
     public:
         explicit lexer(const std::shared_ptr<source_file>& source);
 
+        auto set_source(const std::shared_ptr<source_file>& source) -> void;
         auto set_flags(const std::vector<std::string>& flags) -> void;
         auto add_flag(const std::string& flag) -> void;
         [[nodiscard]] auto has_flag(const std::string& flag) const -> bool;
 
+        auto set_omit_comments(bool omit_comments) -> void;
+
         auto reset() -> void;
         auto scan(bool omit_comments = true) -> std::vector<lexeme>;
+        auto scan_tape(bool omit_comments = true) -> token_tape;
+        auto scan_tape(token_tape& tape, bool omit_comments = true) -> void;
+        auto try_scan_tape(bool omit_comments = true) -> std::optional<token_tape>;
+        auto rescan_tape(const token_tape& previous, const text_edit& edit) -> token_tape;
+        auto next() -> std::optional<lexeme>;
+
+        auto begin() -> iterator;
+        auto end() -> iterator;
 
         [[nodiscard]] auto eof() const -> bool;
         [[nodiscard]] auto source_position() const -> std::size_t;
         [[nodiscard]] auto line() const -> std::size_t;
         [[nodiscard]] auto offset() const -> std::size_t;
-        [[nodiscard]] auto lexemes() const -> std::vector<lexeme>;
+        [[nodiscard]] auto lexemes() const -> const std::vector<lexeme>&;
 
     private:
+        auto scan_next() -> void;
+        auto scan_lexeme() -> void;
+        auto skip_inactive() -> void;
+        [[nodiscard]] auto chunk_boundaries() const -> std::vector<std::size_t>;
+        auto scan_chunks(const std::vector<std::size_t>& boundaries) -> void;
+        [[nodiscard]] auto state() const -> lexer_state;
+        auto restore(const lexer_state& state) -> void;
+
         [[nodiscard]] auto generate_file_reference() const -> file_reference;
 
-        auto save_cursor() -> void;
-        auto restore_cursor() -> void;
-        auto detached_cursor(const std::function<auto(lexer&)->bool>& ctx) -> void;
+        auto advance(std::size_t count = 1) -> void;
+        [[nodiscard]] auto has_available(std::size_t offset = 0, std::size_t count = 1) const -> bool;
+        [[nodiscard]] auto peek(std::size_t offset = 0) const -> char;
+        [[nodiscard]] auto test(char c, std::size_t offset = 0) const -> bool;
+        [[nodiscard]] auto test(std::string_view sequence, std::size_t offset = 0) const -> bool;
+        [[nodiscard]] auto test_class(std::uint8_t char_class, std::size_t offset = 0) const -> bool;
 
-        auto advance(std::int32_t offset = 1) -> void;
-        [[nodiscard]] auto has_available(std::int32_t offset = 0, std::size_t count = 1) const -> bool;
-        [[nodiscard]] auto peek(std::size_t count = 1, std::int32_t offset = 0) const -> std::string;
-        auto read(std::size_t count = 1, std::int32_t offset = 0) -> std::string;
+        auto begin_slice() -> void;
+        auto consume(std::uint8_t char_class) -> bool;
+        auto consume_identifier() -> bool;
+        auto consume_until(char c) -> bool;
+        auto consume_string() -> void;
+        [[nodiscard]] auto slice() const -> std::string_view;
 
-        auto test(const std::function<auto(const std::string&)->bool>& fn, std::int32_t offset = 0, std::size_t count = 1) const -> bool;
-        auto test(const std::function<auto(std::size_t, const std::string&)->bool>& fn, std::int32_t offset = 0, std::size_t count = 1) const -> bool;
-        auto consume(const std::function<auto(const std::string&)->bool>& fn, std::size_t count = 1) -> bool;
-        auto consume(const std::function<auto(std::size_t, const std::string&)->bool>& fn, std::size_t count = 1) -> bool;
+        auto scan_newline() -> void;
+        auto scan_directive() -> void;
+        auto push_condition(bool active) -> void;
+        [[nodiscard]] auto is_inactive() const -> bool;
+        auto scan_resource_reference() -> void;
+        auto scan_number() -> void;
+        [[nodiscard]] auto test_color() const -> bool;
 
         auto mark_lexeme_start() -> void;
         [[nodiscard]] auto construct_lexeme(lexeme_type type) const -> lexeme;
-        [[nodiscard]] auto construct_lexeme(lexeme_type type, const std::string& value) const -> lexeme;
-        auto inject_lexeme(lexeme lx) -> void;
+        auto emit(lexeme_type type) -> void;
+        auto emit_next(lexeme_type type, std::size_t count = 1) -> void;
+        [[noreturn]] auto error(const std::string& message) const -> void;
 
     private:
-        std::vector<std::string> m_flags {{ "extended" }};
+        flag_set m_flags { std::vector<std::string> { "extended" } };
         std::vector<lexeme> m_lexemes;
-        std::vector<std::size_t> m_cursor_stack;
+        std::deque<lexeme> m_pending;
+        std::optional<lexeme> m_previous;
+        token_tape *m_tape { nullptr };
         std::shared_ptr<source_file> m_source;
-        std::string m_consume_slice;
+        std::string_view m_text;
+        std::size_t m_slice_start { 0 };
+        std::size_t m_slice_end { 0 };
         std::size_t m_cursor { 0 };
         std::size_t m_line { 1 };
         std::size_t m_line_offset { 0 };
         std::size_t m_marker { 0 };
         std::size_t m_expr_paren_balance { 0 };
         bool m_in_expr { false };
-        bool m_ignore_lexemes { false };
+        std::uint64_t m_inactive_conditions { 0 };
+        std::uint8_t m_condition_depth { 0 };
+        bool m_omit_comments { true };
+        bool m_speculative { false };
+        std::size_t m_next_checkpoint { 0 };
     };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,47 @@
+// Copyright (c) 2021 Tom Hancocks
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace kdl::lib
+{
+    /* The state of the lexer between two lexemes. Scanning the same source from two equal states will always
+     * produce the same lexemes, which allows scanning to be resumed, or work from another scan to be reused.
+     */
+    struct lexer_state
+    {
+        std::size_t cursor { 0 };
+        std::size_t line_offset { 0 };
+        std::size_t expr_paren_balance { 0 };
+        bool in_expr { false };
+        std::uint64_t inactive_conditions { 0 };
+        std::uint8_t condition_depth { 0 };
+
+        auto operator==(const lexer_state& other) const -> bool
+        {
+            return cursor == other.cursor && line_offset == other.line_offset
+                && expr_paren_balance == other.expr_paren_balance && in_expr == other.in_expr
+                && inactive_conditions == other.inactive_conditions && condition_depth == other.condition_depth;
+        }
+    };
+}
@@ -21,185 +21,95 @@
 #if !defined(LEXICAL_RULES_HPP)
 #define LEXICAL_RULES_HPP
 
-#include <iostream>
+#include <array>
+#include <cstdint>
+#include <kdl/lexer/lexeme_type.hpp>
+
 namespace kdl::lib::lexical_rule
 {
-
-    template<char c>
-    struct match
+    /* Each byte of a source file is classified once through a 256 entry table, rather than being tested
+     * against a series of predicates. A byte can belong to several classes at the same time.
+     */
+    enum char_class : std::uint8_t
     {
-        static auto yes(const std::string& chk) -> bool
-        {
-            return chk == std::string(1, c);
-        }
-
-        static auto no(const std::string& chk) -> bool
-        {
-            return !yes(chk);
-        }
+        none = 0,
+        whitespace = 1 << 0,
+        identifier_head = 1 << 1,
+        identifier = 1 << 2,
+        decimal = 1 << 3,
+        hexadecimal = 1 << 4,
     };
 
-    template<char tc, char...ttc>
-    struct sequence
+    static constexpr auto build_class_table() -> std::array<std::uint8_t, 256>
     {
-        static auto matches(const std::string& chk) -> bool
-        {
-            std::vector<char> v = {tc, ttc...};
-            if (v.size() != chk.size()) {
-                return false;
-            }
-            for (auto i = 0; i < v.size(); ++i) {
-                if (chk[i] != v[i]) {
-                    return false;
-                }
-            }
-            return true;
-        }
+        std::array<std::uint8_t, 256> table {};
 
-        static auto mismatch(const std::string& chk) -> bool
-        {
-            return !matches(chk);
-        }
-    };
+        table[' '] = table['\t'] = whitespace;
 
-    template<char lc, char uc>
-    struct range
-    {
-        static auto contains(const std::string& chk) -> bool
-        {
-            for (const auto c : chk) {
-                if (c < lc || c > uc) {
-                    return false;
-                }
-            }
-            return true;
+        for (auto c = 'A'; c <= 'Z'; ++c) {
+            table[c] = identifier_head | identifier;
         }
-
-        static auto missing(const std::string& chk) -> bool
-        {
-            return !contains(chk);
-        }
-    };
-
-    template<char tc, char...ttc>
-    struct set
-    {
-        static auto contains(const std::string& chk) -> bool
-        {
-            std::vector<char> v = {tc, ttc...};
-            return !std::any_of(chk.begin(), chk.end(), [&] (const char c) {
-                return std::find(v.begin(), v.end(), c) == v.end();
-            });
+        for (auto c = 'a'; c <= 'z'; ++c) {
+            table[c] = identifier_head | identifier;
         }
+        table['_'] = identifier_head | identifier;
 
-        static auto missing(const std::string& chk) -> bool
-        {
-            return !contains(chk);
+        for (auto c = '0'; c <= '9'; ++c) {
+            table[c] = identifier | decimal | hexadecimal;
         }
-    };
-
-    struct identifier
-    {
-        struct set
-        {
-            static auto contains(const std::string& chk) -> bool
-            {
-                return range<'A', 'Z'>::contains(chk)
-                    || range<'a', 'z'>::contains(chk)
-                    || range<'0', '9'>::contains(chk)
-                    || match<'_'>::yes(chk);
-            }
-
-            static auto missing(const std::string& chk) -> bool
-            {
-                return !contains(chk);
-            }
-        };
-
-        struct limited_set
-        {
-            static auto contains(const std::string& chk) -> bool
-            {
-                return range<'A', 'Z'>::contains(chk)
-                    || range<'a', 'z'>::contains(chk)
-                    || match<'_'>::yes(chk);
-            }
-
-            static auto missing(const std::string& chk) -> bool
-            {
-                return !contains(chk);
-            }
-        };
-
-        static auto matches(std::size_t pos, const std::string& chk) -> bool
-        {
-            for (auto it = chk.begin(); it != chk.end(); ++it) {
-                auto fn = (it == chk.begin() && pos == 0) ? limited_set::contains : set::contains;
-                if (!fn(std::string(1, *it))) {
-                    return false;
-                }
-            }
-            return true;
+        for (auto c = 'A'; c <= 'F'; ++c) {
+            table[c] |= hexadecimal;
+            table[c + ('a' - 'A')] |= hexadecimal;
         }
 
-        static auto mismatch(std::size_t pos, const std::string& chk) -> bool
-        {
-            return !matches(pos, chk);
-        }
-    };
+        return table;
+    }
 
-    struct numeric
+    /* Single character operators map directly on to the type of lexeme they produce. Multi-character operators
+     * (::, << and >>) are resolved by the lexer before this table is consulted.
+     */
+    static constexpr auto build_punctuation_table() -> std::array<lexeme_type, 256>
     {
-        typedef lexical_rule::range<'0', '9'> decimal;
-
-        struct hexadecimal
-        {
-            static auto contains(const std::string& chk) -> bool
-            {
-                return std::all_of(chk.begin(), chk.end(), [&] (const char c) {
-                    return (c >= 'A' && c <= 'F')
-                    || (c >= 'a' && c <= 'f')
-                    || (c >= '0' && c <= '9');
-                });
-            }
-
-            static auto missing(const std::string& chk) -> bool
-            {
-                return !contains(chk);
-            }
-
-            static auto matches(const std::string& chk) -> bool
-            {
-                if (chk[0] == '0' && (chk[1] == 'x' || chk[1] == 'X')) {
-                    return contains(chk.substr(2));
-                }
-                else {
-                    return contains(chk);
-                }
-            }
-
-            static auto mismatch(const std::string& chk) -> bool
-            {
-                return !matches(chk);
-            }
-        };
-
-        static auto matches(const std::string& chk) -> bool
-        {
-            return decimal::contains(chk)
-                || hexadecimal::matches(chk)
-                || set<'-'>::contains(chk);
-        }
-
-        static auto mismatch(const std::string& chk) -> bool
-        {
-            return !matches(chk);
-        }
-    };
+        std::array<lexeme_type, 256> table {};
+        table[';'] = lexeme_type::semicolon;
+        table[':'] = lexeme_type::colon;
+        table['*'] = lexeme_type::star;
+        table['+'] = lexeme_type::plus;
+        table['-'] = lexeme_type::minus;
+        table['='] = lexeme_type::equals;
+        table['!'] = lexeme_type::exclaim;
+        table['?'] = lexeme_type::question;
+        table['^'] = lexeme_type::carat;
+        table['&'] = lexeme_type::amp;
+        table['('] = lexeme_type::lparen;
+        table[')'] = lexeme_type::rparen;
+        table['['] = lexeme_type::lbracket;
+        table[']'] = lexeme_type::rbracket;
+        table['<'] = lexeme_type::langle;
+        table['>'] = lexeme_type::rangle;
+        table['{'] = lexeme_type::lbrace;
+        table['}'] = lexeme_type::rbrace;
+        table['.'] = lexeme_type::dot;
+        table[','] = lexeme_type::comma;
+        table['|'] = lexeme_type::bar;
+        table['\\'] = lexeme_type::backslash;
+        table['~'] = lexeme_type::tilde;
+        table['/'] = lexeme_type::slash;
+        return table;
+    }
+
+    static constexpr auto class_table = build_class_table();
+    static constexpr auto punctuation_table = build_punctuation_table();
+
+    static constexpr auto is(char c, std::uint8_t cls) -> bool
+    {
+        return (class_table[static_cast<unsigned char>(c)] & cls) != 0;
+    }
 
-    typedef set<' ', '\t'> whitespace;
-    typedef match<'\n'> unix_nl;
-    typedef match<'\r'> cr;
+    static constexpr auto punctuation_type(char c) -> lexeme_type
+    {
+        return punctuation_table[static_cast<unsigned char>(c)];
+    }
 
 }
 
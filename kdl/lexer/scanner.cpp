@@ -0,0 +1,438 @@
+// Copyright (c) 2021 Tom Hancocks
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdint>
+#include <cstring>
+#include <kdl/lexer/scanner.hpp>
+#include <kdl/lexer/lexical_rules.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define KDL_SCANNER_SSE2
+#   include <emmintrin.h>
+#   if defined(__GNUC__)
+#       define KDL_SCANNER_AVX2
+#       include <immintrin.h>
+#   endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__aarch64__)
+#   define KDL_SCANNER_NEON
+#   include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+#   include <intrin.h>
+#endif
+
+// MARK: - Helpers
+
+namespace kdl::lib::scanner
+{
+    static inline auto first_set(std::uint64_t mask) -> unsigned
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+    }
+
+    static inline auto skip_class(const char *begin, const char *end, std::uint8_t char_class) -> const char *
+    {
+        while (begin < end && lexical_rule::is(*begin, char_class)) {
+            ++begin;
+        }
+        return begin;
+    }
+}
+
+// MARK: - Scalar Kernels
+
+namespace kdl::lib::scanner::scalar
+{
+    static auto find(const char *begin, const char *end, char c) -> const char *
+    {
+        auto ptr = std::memchr(begin, c, static_cast<std::size_t>(end - begin));
+        return ptr ? static_cast<const char *>(ptr) : end;
+    }
+
+    static auto find_any(const char *begin, const char *end, char a, char b, char c, char d) -> const char *
+    {
+        while (begin < end && *begin != a && *begin != b && *begin != c && *begin != d) {
+            ++begin;
+        }
+        return begin;
+    }
+
+    static auto skip_whitespace(const char *begin, const char *end) -> const char *
+    {
+        return skip_class(begin, end, lexical_rule::whitespace);
+    }
+
+    static auto skip_identifier(const char *begin, const char *end) -> const char *
+    {
+        return skip_class(begin, end, lexical_rule::identifier);
+    }
+}
+
+// MARK: - SSE2 Kernels
+
+#if defined(KDL_SCANNER_SSE2)
+namespace kdl::lib::scanner::sse2
+{
+    /* Bytes above 0x7F compare as negative values, and so never fall inside any of the ranges being tested. */
+    static inline auto identifier_mask(__m128i v) -> __m128i
+    {
+        auto lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+        auto alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), lower));
+        auto digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), v));
+        auto under = _mm_cmpeq_epi8(v, _mm_set1_epi8('_'));
+        return _mm_or_si128(_mm_or_si128(alpha, digit), under);
+    }
+
+    static inline auto whitespace_mask(__m128i v) -> __m128i
+    {
+        return _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')));
+    }
+
+    static auto find(const char *begin, const char *end, char c) -> const char *
+    {
+        auto needle = _mm_set1_epi8(c);
+        for (; end - begin >= 16; begin += 16) {
+            auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+            auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, needle)));
+            if (mask) {
+                return begin + first_set(mask);
+            }
+        }
+        return scalar::find(begin, end, c);
+    }
+
+    static auto find_any(const char *begin, const char *end, char a, char b, char c, char d) -> const char *
+    {
+        auto na = _mm_set1_epi8(a), nb = _mm_set1_epi8(b), nc = _mm_set1_epi8(c), nd = _mm_set1_epi8(d);
+        for (; end - begin >= 16; begin += 16) {
+            auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+            auto match = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(v, na), _mm_cmpeq_epi8(v, nb)),
+                _mm_or_si128(_mm_cmpeq_epi8(v, nc), _mm_cmpeq_epi8(v, nd))
+            );
+            auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(match));
+            if (mask) {
+                return begin + first_set(mask);
+            }
+        }
+        return scalar::find_any(begin, end, a, b, c, d);
+    }
+
+    static auto skip_whitespace(const char *begin, const char *end) -> const char *
+    {
+        for (; end - begin >= 16; begin += 16) {
+            auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+            auto mask = ~static_cast<std::uint32_t>(_mm_movemask_epi8(whitespace_mask(v))) & 0xFFFF;
+            if (mask) {
+                return begin + first_set(mask);
+            }
+        }
+        return scalar::skip_whitespace(begin, end);
+    }
+
+    static auto skip_identifier(const char *begin, const char *end) -> const char *
+    {
+        for (; end - begin >= 16; begin += 16) {
+            auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+            auto mask = ~static_cast<std::uint32_t>(_mm_movemask_epi8(identifier_mask(v))) & 0xFFFF;
+            if (mask) {
+                return begin + first_set(mask);
+            }
+        }
+        return scalar::skip_identifier(begin, end);
+    }
+}
+#endif
+
+// MARK: - AVX2 Kernels
+
+#if defined(KDL_SCANNER_AVX2)
+#define KDL_AVX2 __attribute__((target("avx2")))
+namespace kdl::lib::scanner::avx2
+{
+    KDL_AVX2 static inline auto identifier_mask(__m256i v) -> __m256i
+    {
+        auto lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+        auto alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+        auto digit = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+        auto under = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_'));
+        return _mm256_or_si256(_mm256_or_si256(alpha, digit), under);
+    }
+
+    KDL_AVX2 static inline auto whitespace_mask(__m256i v) -> __m256i
+    {
+        return _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')));
+    }
+
+    KDL_AVX2 static auto find(const char *begin, const char *end, char c) -> const char *
+    {
+        auto needle = _mm256_set1_epi8(c);
+        for (; end - begin >= 32; begin += 32) {
+            auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+            auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, needle)));
+            if (mask) {
+                return begin + first_set(mask);
+            }
+        }
+        return sse2::find(begin, end, c);
+    }
+
+    KDL_AVX2 static auto find_any(const char *begin, const char *end, char a, char b, char c, char d) -> const char *
+    {
+        auto na = _mm256_set1_epi8(a), nb = _mm256_set1_epi8(b), nc = _mm256_set1_epi8(c), nd = _mm256_set1_epi8(d);
+        for (; end - begin >= 32; begin += 32) {
+            auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+            auto match = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, na), _mm256_cmpeq_epi8(v, nb)),
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, nc), _mm256_cmpeq_epi8(v, nd))
+            );
+            auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(match));
+            if (mask) {
+                return begin + first_set(mask);
+            }
+        }
+        return sse2::find_any(begin, end, a, b, c, d);
+    }
+
+    KDL_AVX2 static auto skip_whitespace(const char *begin, const char *end) -> const char *
+    {
+        for (; end - begin >= 32; begin += 32) {
+            auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+            auto mask = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(whitespace_mask(v)));
+            if (mask) {
+                return begin + first_set(mask);
+            }
+        }
+        return sse2::skip_whitespace(begin, end);
+    }
+
+    KDL_AVX2 static auto skip_identifier(const char *begin, const char *end) -> const char *
+    {
+        for (; end - begin >= 32; begin += 32) {
+            auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+            auto mask = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(identifier_mask(v)));
+            if (mask) {
+                return begin + first_set(mask);
+            }
+        }
+        return sse2::skip_identifier(begin, end);
+    }
+}
+#undef KDL_AVX2
+#endif
+
+// MARK: - NEON Kernels
+
+#if defined(KDL_SCANNER_NEON)
+namespace kdl::lib::scanner::neon
+{
+    /* NEON has no equivalent of movemask. Narrowing each 16-bit lane by 4 bits packs the comparison result into
+     * a 64-bit value holding 4 bits per byte, which is enough to locate the first matching byte.
+     */
+    static inline auto byte_mask(uint8x16_t cmp) -> std::uint64_t
+    {
+        auto narrowed = vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4);
+        return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+    }
+
+    static inline auto identifier_mask(uint8x16_t v) -> uint8x16_t
+    {
+        auto lower = vorrq_u8(v, vdupq_n_u8(0x20));
+        auto alpha = vcleq_u8(vsubq_u8(lower, vdupq_n_u8('a')), vdupq_n_u8('z' - 'a'));
+        auto digit = vcleq_u8(vsubq_u8(v, vdupq_n_u8('0')), vdupq_n_u8('9' - '0'));
+        auto under = vceqq_u8(v, vdupq_n_u8('_'));
+        return vorrq_u8(vorrq_u8(alpha, digit), under);
+    }
+
+    static inline auto whitespace_mask(uint8x16_t v) -> uint8x16_t
+    {
+        return vorrq_u8(vceqq_u8(v, vdupq_n_u8(' ')), vceqq_u8(v, vdupq_n_u8('\t')));
+    }
+
+    static auto find(const char *begin, const char *end, char c) -> const char *
+    {
+        auto needle = vdupq_n_u8(static_cast<std::uint8_t>(c));
+        for (; end - begin >= 16; begin += 16) {
+            auto v = vld1q_u8(reinterpret_cast<const std::uint8_t *>(begin));
+            auto mask = byte_mask(vceqq_u8(v, needle));
+            if (mask) {
+                return begin + (first_set(mask) >> 2);
+            }
+        }
+        return scalar::find(begin, end, c);
+    }
+
+    static auto find_any(const char *begin, const char *end, char a, char b, char c, char d) -> const char *
+    {
+        auto na = vdupq_n_u8(static_cast<std::uint8_t>(a)), nb = vdupq_n_u8(static_cast<std::uint8_t>(b));
+        auto nc = vdupq_n_u8(static_cast<std::uint8_t>(c)), nd = vdupq_n_u8(static_cast<std::uint8_t>(d));
+        for (; end - begin >= 16; begin += 16) {
+            auto v = vld1q_u8(reinterpret_cast<const std::uint8_t *>(begin));
+            auto match = vorrq_u8(vorrq_u8(vceqq_u8(v, na), vceqq_u8(v, nb)), vorrq_u8(vceqq_u8(v, nc), vceqq_u8(v, nd)));
+            auto mask = byte_mask(match);
+            if (mask) {
+                return begin + (first_set(mask) >> 2);
+            }
+        }
+        return scalar::find_any(begin, end, a, b, c, d);
+    }
+
+    static auto skip_whitespace(const char *begin, const char *end) -> const char *
+    {
+        for (; end - begin >= 16; begin += 16) {
+            auto v = vld1q_u8(reinterpret_cast<const std::uint8_t *>(begin));
+            auto mask = byte_mask(vmvnq_u8(whitespace_mask(v)));
+            if (mask) {
+                return begin + (first_set(mask) >> 2);
+            }
+        }
+        return scalar::skip_whitespace(begin, end);
+    }
+
+    static auto skip_identifier(const char *begin, const char *end) -> const char *
+    {
+        for (; end - begin >= 16; begin += 16) {
+            auto v = vld1q_u8(reinterpret_cast<const std::uint8_t *>(begin));
+            auto mask = byte_mask(vmvnq_u8(identifier_mask(v)));
+            if (mask) {
+                return begin + (first_set(mask) >> 2);
+            }
+        }
+        return scalar::skip_identifier(begin, end);
+    }
+}
+#endif
+
+// MARK: - Dispatch
+
+namespace kdl::lib::scanner
+{
+    struct kernels
+    {
+        implementation impl;
+        auto (*find)(const char *, const char *, char) -> const char *;
+        auto (*find_any)(const char *, const char *, char, char, char, char) -> const char *;
+        auto (*skip_whitespace)(const char *, const char *) -> const char *;
+        auto (*skip_identifier)(const char *, const char *) -> const char *;
+    };
+
+    static auto kernels_for(implementation impl) -> kernels
+    {
+        switch (impl) {
+#if defined(KDL_SCANNER_AVX2)
+            case implementation::avx2:
+                return { impl, avx2::find, avx2::find_any, avx2::skip_whitespace, avx2::skip_identifier };
+#endif
+#if defined(KDL_SCANNER_SSE2)
+            case implementation::sse2:
+                return { impl, sse2::find, sse2::find_any, sse2::skip_whitespace, sse2::skip_identifier };
+#endif
+#if defined(KDL_SCANNER_NEON)
+            case implementation::neon:
+                return { impl, neon::find, neon::find_any, neon::skip_whitespace, neon::skip_identifier };
+#endif
+            default:
+                return { implementation::scalar, scalar::find, scalar::find_any, scalar::skip_whitespace, scalar::skip_identifier };
+        }
+    }
+
+    static auto best_implementation() -> implementation
+    {
+        for (auto impl : { implementation::avx2, implementation::sse2, implementation::neon }) {
+            if (is_supported(impl)) {
+                return impl;
+            }
+        }
+        return implementation::scalar;
+    }
+
+    static auto active() -> kernels&
+    {
+        static kernels active_kernels = kernels_for(best_implementation());
+        return active_kernels;
+    }
+}
+
+auto kdl::lib::scanner::is_supported(implementation impl) -> bool
+{
+    switch (impl) {
+        case implementation::scalar:
+            return true;
+#if defined(KDL_SCANNER_AVX2)
+        case implementation::avx2:
+            return __builtin_cpu_supports("avx2");
+#endif
+#if defined(KDL_SCANNER_SSE2)
+        case implementation::sse2:
+            return true;
+#endif
+#if defined(KDL_SCANNER_NEON)
+        case implementation::neon:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+auto kdl::lib::scanner::active_implementation() -> implementation
+{
+    return active().impl;
+}
+
+auto kdl::lib::scanner::select_implementation(implementation impl) -> bool
+{
+    if (!is_supported(impl)) {
+        return false;
+    }
+    active() = kernels_for(impl);
+    return true;
+}
+
+// MARK: - Kernels
+
+auto kdl::lib::scanner::find(const char *begin, const char *end, char c) -> const char *
+{
+    return active().find(begin, end, c);
+}
+
+auto kdl::lib::scanner::find_any(const char *begin, const char *end, char a, char b, char c, char d) -> const char *
+{
+    return active().find_any(begin, end, a, b, c, d);
+}
+
+auto kdl::lib::scanner::skip_whitespace(const char *begin, const char *end) -> const char *
+{
+    return active().skip_whitespace(begin, end);
+}
+
+auto kdl::lib::scanner::skip_identifier(const char *begin, const char *end) -> const char *
+{
+    return active().skip_identifier(begin, end);
+}
@@ -0,0 +1,42 @@
+// Copyright (c) 2021 Tom Hancocks
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+namespace kdl::lib::scanner
+{
+    /* The scanner provides the bulk scanning kernels used by the lexer to skip over long runs of bytes, such
+     * as whitespace, identifiers, comments and string literals, several bytes at a time. The best kernel for the
+     * host processor is selected the first time the scanner is used.
+     */
+    enum class implementation { scalar, sse2, avx2, neon };
+
+    [[nodiscard]] auto active_implementation() -> implementation;
+    [[nodiscard]] auto is_supported(implementation impl) -> bool;
+    auto select_implementation(implementation impl) -> bool;
+
+    /* Each kernel scans the range [begin, end) and returns a pointer to the first byte that terminates the run,
+     * or end if the run extends to the end of the range.
+     */
+    [[nodiscard]] auto find(const char *begin, const char *end, char c) -> const char *;
+    [[nodiscard]] auto find_any(const char *begin, const char *end, char a, char b, char c, char d) -> const char *;
+    [[nodiscard]] auto skip_whitespace(const char *begin, const char *end) -> const char *;
+    [[nodiscard]] auto skip_identifier(const char *begin, const char *end) -> const char *;
+}
@@ -0,0 +1,260 @@
+// Copyright (c) 2021 Tom Hancocks
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdlib>
+#include <vector>
+#include <kdl/lexer/source_registry.hpp>
+#include <kdl/lexer/lexer.hpp>
+
+#if defined(_WIN32)
+#   define KDL_CANONICAL_PATH(path, resolved) _fullpath(resolved, path, sizeof(resolved))
+#   define KDL_PATH_MAX 260
+#else
+#   include <climits>
+#   define KDL_CANONICAL_PATH(path, resolved) realpath(path, resolved)
+#   define KDL_PATH_MAX PATH_MAX
+#endif
+
+// MARK: - Shared Registry
+
+kdl::lib::source_registry::~source_registry()
+{
+    wait_for_prefetches();
+}
+
+auto kdl::lib::source_registry::shared() -> source_registry&
+{
+    static source_registry registry;
+    return registry;
+}
+
+// MARK: - Identity
+
+auto kdl::lib::source_registry::canonical_path(const std::string& path) -> std::string
+{
+    // If the path can not be resolved (for instance if the file does not exist) it is used as given.
+    char resolved[KDL_PATH_MAX + 1] = { 0 };
+    if (KDL_CANONICAL_PATH(path.c_str(), resolved)) {
+        return resolved;
+    }
+    return path;
+}
+
+auto kdl::lib::source_registry::content_hash(std::string_view contents) -> std::uint64_t
+{
+    // FNV-1a
+    std::uint64_t hash = 14695981039346656037ull;
+    for (auto c : contents) {
+        hash = (hash ^ static_cast<std::uint8_t>(c)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// MARK: - Loading
+
+auto kdl::lib::source_registry::load(const std::string& path) -> std::shared_ptr<source_file>
+{
+    auto canonical = canonical_path(path);
+    std::shared_future<void> prefetch;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (auto it = m_files.find(canonical); it != m_files.end()) {
+            return it->second->file;
+        }
+        if (auto it = m_prefetches.find(canonical); it != m_prefetches.end()) {
+            prefetch = it->second;
+        }
+    }
+
+    // If the file is already being loaded in the background, then wait for it rather than loading it again.
+    if (prefetch.valid()) {
+        prefetch.wait();
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (auto it = m_files.find(canonical); it != m_files.end()) {
+            return it->second->file;
+        }
+    }
+
+    // The file keeps the path that it was requested with, so that diagnostics refer to it as the user wrote it.
+    return insert(canonical, std::make_shared<source_file>("", path))->file;
+}
+
+auto kdl::lib::source_registry::insert(const std::string& canonical, std::shared_ptr<source_file> file) -> std::shared_ptr<entry>
+{
+    // Files are read and hashed outside of the lock. If another thread loaded the same file in the mean time, then
+    // its copy is used instead.
+    auto record = std::make_shared<entry>();
+    record->hash = content_hash(file->source());
+    record->file = std::move(file);
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    auto [it, inserted] = m_files.emplace(canonical, record);
+    if (inserted) {
+        m_entries.emplace(record->file.get(), record);
+    }
+    return it->second;
+}
+
+auto kdl::lib::source_registry::entry_for(const std::shared_ptr<source_file>& file) -> std::shared_ptr<entry>
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (auto it = m_entries.find(file.get()); it != m_entries.end()) {
+        return it->second;
+    }
+
+    // Files that were not loaded through the registry (such as in memory sources) are still tracked, so that
+    // their tokens and hash are cached.
+    auto record = std::make_shared<entry>();
+    record->file = file;
+    record->hash = content_hash(file->source());
+    m_entries.emplace(file.get(), record);
+    return record;
+}
+
+auto kdl::lib::source_registry::tokens(const std::shared_ptr<source_file>& file) -> std::shared_ptr<const token_tape>
+{
+    auto record = entry_for(file);
+    std::lock_guard<std::mutex> lock(record->scan_lock);
+    if (!record->tokens) {
+        record->tokens = std::make_shared<token_tape>(lexer(record->file).scan_tape());
+    }
+    return record->tokens;
+}
+
+auto kdl::lib::source_registry::hash(const std::shared_ptr<source_file>& file) -> std::uint64_t
+{
+    return entry_for(file)->hash;
+}
+
+// MARK: - Prefetching
+
+auto kdl::lib::source_registry::prefetch(const std::string& path) -> void
+{
+    auto canonical = canonical_path(path);
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (m_files.find(canonical) != m_files.end() || m_prefetches.find(canonical) != m_prefetches.end()) {
+        return;
+    }
+
+    m_prefetches.emplace(canonical, std::async(std::launch::async, [this, path, canonical] {
+        auto record = insert(canonical, std::make_shared<source_file>("", path));
+        {
+            std::lock_guard<std::mutex> scan_lock(record->scan_lock);
+            if (!record->tokens) {
+                if (auto tape = lexer(record->file).try_scan_tape()) {
+                    record->tokens = std::make_shared<token_tape>(std::move(*tape));
+                }
+            }
+        }
+        if (record->tokens) {
+            prefetch_imports(*record->tokens);
+        }
+    }).share());
+}
+
+auto kdl::lib::source_registry::prefetch_imports(const token_tape& tape) -> void
+{
+    // Import paths are relative to the file that contains the directive.
+    const auto& source = tape.source();
+    for (auto i : tape.imports()) {
+        prefetch(source->relative_path(lexeme::unescape(tape.text(i))));
+    }
+}
+
+auto kdl::lib::source_registry::wait_for_prefetches() -> void
+{
+    // Prefetches may start further prefetches, so keep waiting until no new ones have been started.
+    std::vector<std::shared_future<void>> pending;
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            if (pending.size() == m_prefetches.size()) {
+                return;
+            }
+            pending.clear();
+            for (const auto& it : m_prefetches) {
+                pending.emplace_back(it.second);
+            }
+        }
+        for (const auto& prefetch : pending) {
+            prefetch.wait();
+        }
+    }
+}
+
+// MARK: - Include Once
+
+auto kdl::lib::source_registry::set_include_once(bool include_once) -> void
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_include_once = include_once;
+}
+
+auto kdl::lib::source_registry::include_once() const -> bool
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_include_once;
+}
+
+auto kdl::lib::source_registry::mark_included(const std::shared_ptr<source_file>& file) -> bool
+{
+    auto file_hash = hash(file);
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_included.insert(file_hash).second;
+}
+
+auto kdl::lib::source_registry::should_include(const std::shared_ptr<source_file>& file) -> bool
+{
+    return mark_included(file) || !include_once();
+}
+
+auto kdl::lib::source_registry::reset_includes() -> void
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_included.clear();
+}
+
+// MARK: - Invalidation
+
+auto kdl::lib::source_registry::invalidate(const std::string& path) -> void
+{
+    auto canonical = canonical_path(path);
+    wait_for_prefetches();
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_prefetches.erase(canonical);
+    if (auto it = m_files.find(canonical); it != m_files.end()) {
+        m_entries.erase(it->second->file.get());
+        m_files.erase(it);
+    }
+}
+
+auto kdl::lib::source_registry::clear() -> void
+{
+    wait_for_prefetches();
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_prefetches.clear();
+    m_files.clear();
+    m_entries.clear();
+    m_included.clear();
+}
@@ -0,0 +1,97 @@
+// Copyright (c) 2021 Tom Hancocks
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <mutex>
+#include <future>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <kdl/file/source_file.hpp>
+#include <kdl/lexer/token_tape.hpp>
+
+namespace kdl::lib
+{
+    /* The source registry caches the source files that are loaded from disk, keyed by their canonical path, so that
+     * a file that is imported or referenced many times is only loaded once. The token tape of each file is also
+     * cached, so that it is only scanned once.
+     *
+     * Each file is identified by a hash of its contents. When include once is enabled, a file whose contents have
+     * already been imported (through any path) is not imported again until the includes are reset. The builtin
+     * modules are always only included once.
+     *
+     * Files named by @import directives can be prefetched: they are read and scanned on a background thread, along
+     * with anything they import in turn, so that they are ready by the time the parser reaches the directive. Errors
+     * in a prefetched file are not reported by the prefetch, but when the file is scanned again on request.
+     */
+    class source_registry
+    {
+    public:
+        source_registry() = default;
+        source_registry(const source_registry&) = delete;
+        auto operator=(const source_registry&) -> source_registry& = delete;
+        ~source_registry();
+
+        static auto shared() -> source_registry&;
+
+        [[nodiscard]] static auto canonical_path(const std::string& path) -> std::string;
+        [[nodiscard]] static auto content_hash(std::string_view contents) -> std::uint64_t;
+
+        auto load(const std::string& path) -> std::shared_ptr<source_file>;
+        auto tokens(const std::shared_ptr<source_file>& file) -> std::shared_ptr<const token_tape>;
+        [[nodiscard]] auto hash(const std::shared_ptr<source_file>& file) -> std::uint64_t;
+
+        auto prefetch(const std::string& path) -> void;
+        auto prefetch_imports(const token_tape& tape) -> void;
+
+        auto set_include_once(bool include_once) -> void;
+        [[nodiscard]] auto include_once() const -> bool;
+        auto mark_included(const std::shared_ptr<source_file>& file) -> bool;
+        auto should_include(const std::shared_ptr<source_file>& file) -> bool;
+        auto reset_includes() -> void;
+
+        auto invalidate(const std::string& path) -> void;
+        auto clear() -> void;
+
+    private:
+        struct entry
+        {
+            std::shared_ptr<source_file> file;
+            std::uint64_t hash { 0 };
+            std::mutex scan_lock;
+            std::shared_ptr<const token_tape> tokens;
+        };
+
+        auto insert(const std::string& canonical, std::shared_ptr<source_file> file) -> std::shared_ptr<entry>;
+        auto entry_for(const std::shared_ptr<source_file>& file) -> std::shared_ptr<entry>;
+        auto wait_for_prefetches() -> void;
+
+        mutable std::mutex m_lock;
+        std::unordered_map<std::string, std::shared_ptr<entry>> m_files;
+        std::unordered_map<const source_file *, std::shared_ptr<entry>> m_entries;
+        std::unordered_map<std::string, std::shared_future<void>> m_prefetches;
+        std::unordered_set<std::uint64_t> m_included;
+        bool m_include_once { false };
+    };
+}
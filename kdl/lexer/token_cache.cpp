@@ -0,0 +1,119 @@
+// Copyright (c) 2021 Tom Hancocks
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <functional>
+#include <kdl/lexer/token_cache.hpp>
+#include <kdl/lexer/source_registry.hpp>
+
+// MARK: - Shared Cache
+
+auto kdl::lib::token_cache::shared() -> token_cache&
+{
+    static token_cache cache;
+    return cache;
+}
+
+// MARK: - Configuration
+
+auto kdl::lib::token_cache::set_directory(const std::string& directory) -> void
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_directory = directory;
+    if (!m_directory.empty() && m_directory.back() != '/') {
+        m_directory += '/';
+    }
+}
+
+auto kdl::lib::token_cache::directory() const -> std::string
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_directory;
+}
+
+auto kdl::lib::token_cache::enabled() const -> bool
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return !m_directory.empty();
+}
+
+// MARK: - Keys
+
+auto kdl::lib::token_cache::path_for(const token_tape& tape, const flag_set& flags, bool omit_comments) const -> std::string
+{
+    // The order in which flags were set does not affect the tokens produced, so they are sorted before hashing.
+    auto names = flags.names();
+    std::sort(names.begin(), names.end());
+    std::string flag_key { omit_comments ? "-" : "+" };
+    for (const auto& name : names) {
+        flag_key += name;
+        flag_key += '\0';
+    }
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "%016llx-%016llx.kdlt",
+                  static_cast<unsigned long long>(source_registry::content_hash(tape.source()->source())),
+                  static_cast<unsigned long long>(source_registry::content_hash(flag_key)));
+    return directory() + name;
+}
+
+// MARK: - Loading & Storing
+
+auto kdl::lib::token_cache::load(token_tape& tape, const flag_set& flags, bool omit_comments) const -> bool
+{
+    // Cached tapes are memory mapped where possible. A missing cache entry simply has no contents.
+    source_file cached { "", path_for(tape, flags, omit_comments) };
+    if (cached.size() == 0) {
+        return false;
+    }
+    return tape.deserialize(cached.source());
+}
+
+auto kdl::lib::token_cache::store(const token_tape& tape, const flag_set& flags, bool omit_comments) const -> void
+{
+    static std::atomic<std::uint64_t> s_counter { 0 };
+
+    auto path = path_for(tape, flags, omit_comments);
+    auto temporary = path + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()))
+                   + "." + std::to_string(s_counter++) + ".tmp";
+
+    auto data = tape.serialize();
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            return;
+        }
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!out.good()) {
+            out.close();
+            std::remove(temporary.c_str());
+            return;
+        }
+    }
+
+    // Failing to write to the cache is not an error, the tape will just be scanned again next time.
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+    }
+}
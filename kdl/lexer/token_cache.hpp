@@ -0,0 +1,57 @@
+// Copyright (c) 2021 Tom Hancocks
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <cstdint>
+#include <kdl/lexer/token_tape.hpp>
+#include <kdl/lexer/flag_set.hpp>
+
+namespace kdl::lib
+{
+    /* The token cache stores the token tapes of scanned source files in a directory on disk, so that unchanged
+     * files do not need to be scanned again by later builds. Each tape is keyed by a hash of the contents of its
+     * source, along with the lexer flags and comment handling that it was scanned with, as conditional blocks
+     * change the tokens that are produced.
+     *
+     * The cache is disabled until a directory is set. The directory must already exist. Cached tapes are written
+     * to a temporary file and then renamed in to place, so that concurrent builds never see a partial tape.
+     */
+    class token_cache
+    {
+    public:
+        static auto shared() -> token_cache&;
+
+        auto set_directory(const std::string& directory) -> void;
+        [[nodiscard]] auto directory() const -> std::string;
+        [[nodiscard]] auto enabled() const -> bool;
+
+        auto load(token_tape& tape, const flag_set& flags, bool omit_comments) const -> bool;
+        auto store(const token_tape& tape, const flag_set& flags, bool omit_comments) const -> void;
+
+    private:
+        [[nodiscard]] auto path_for(const token_tape& tape, const flag_set& flags, bool omit_comments) const -> std::string;
+
+        mutable std::mutex m_lock;
+        std::string m_directory;
+    };
+}
@@ -0,0 +1,426 @@
+// Copyright (c) 2021 Tom Hancocks
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <utility>
+#include <cstring>
+#include <kdl/lexer/token_tape.hpp>
+
+// MARK: - Value Ranges
+
+namespace kdl::lib
+{
+    /* The value of a token excludes any sigil or prefix that introduced it, and any unit that follows it. */
+    static auto value_prefix(lexeme_type type) -> std::size_t
+    {
+        switch (type) {
+            case lexeme_type::comment:
+            case lexeme_type::directive:
+            case lexeme_type::string:
+            case lexeme_type::var:
+            case lexeme_type::resource_ref:
+            case lexeme_type::lexpr:
+                return 1;
+            case lexeme_type::color:
+            case lexeme_type::hex:
+                return 2;
+            default:
+                return 0;
+        }
+    }
+
+    static auto value_suffix(lexeme_type type) -> std::size_t
+    {
+        return (type == lexeme_type::percentage) ? 1 : 0;
+    }
+}
+
+// MARK: - Delimiters
+
+namespace kdl::lib
+{
+    /* Each kind of delimiter is paired independently of the others, so an unbalanced parenthesis does not stop the
+     * braces around it from matching.
+     */
+    static constexpr std::size_t no_delimiter { 3 };
+
+    static auto delimiter_kind(lexeme_type type) -> std::size_t
+    {
+        switch (type) {
+            case lexeme_type::lbrace:
+            case lexeme_type::rbrace:
+                return 0;
+            case lexeme_type::lparen:
+            case lexeme_type::rparen:
+                return 1;
+            case lexeme_type::lbracket:
+            case lexeme_type::rbracket:
+                return 2;
+            default:
+                return no_delimiter;
+        }
+    }
+}
+
+// MARK: - Serialization Helpers
+
+namespace kdl::lib
+{
+    static constexpr std::uint32_t tape_magic { 0x544c444b };
+    static constexpr std::uint32_t tape_version { 3 };
+    static constexpr std::uint32_t unmatched { 0xFFFFFFFF };
+
+    template<typename T>
+    static auto write(std::string& out, const T& value) -> void
+    {
+        out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    static auto write(std::string& out, const std::vector<T>& values) -> void
+    {
+        out.append(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+    }
+
+    /* Reads values back out of serialized data, failing rather than reading past the end of the data. */
+    struct tape_reader
+    {
+        std::string_view data;
+
+        template<typename T>
+        auto read(T& value) -> bool
+        {
+            if (data.size() < sizeof(T)) {
+                return false;
+            }
+            std::memcpy(&value, data.data(), sizeof(T));
+            data.remove_prefix(sizeof(T));
+            return true;
+        }
+
+        template<typename T>
+        auto read(std::vector<T>& values, std::uint64_t count) -> bool
+        {
+            if (data.size() / sizeof(T) < count) {
+                return false;
+            }
+            values.resize(static_cast<std::size_t>(count));
+            std::memcpy(values.data(), data.data(), values.size() * sizeof(T));
+            data.remove_prefix(values.size() * sizeof(T));
+            return true;
+        }
+    };
+}
+
+// MARK: - Construction
+
+kdl::lib::token_tape::token_tape(std::shared_ptr<source_file> source)
+    : m_source(std::move(source)), m_text(m_source->source())
+{
+
+}
+
+auto kdl::lib::token_tape::reset(std::shared_ptr<source_file> source) -> void
+{
+    m_source = std::move(source);
+    m_text = m_source->source();
+    m_types.clear();
+    m_offsets.clear();
+    m_lengths.clear();
+    m_keywords.clear();
+    m_line_starts.clear();
+    m_line_starts.emplace_back(0);
+    m_checkpoints.clear();
+    m_imports.clear();
+    m_matches.clear();
+    for (auto& open : m_open_delimiters) {
+        open.clear();
+    }
+}
+
+// MARK: - Recording
+
+auto kdl::lib::token_tape::push(lexeme_type type, std::size_t offset, std::size_t length) -> void
+{
+    m_types.emplace_back(static_cast<std::uint8_t>(type));
+    m_offsets.emplace_back(static_cast<std::uint32_t>(offset));
+    m_lengths.emplace_back(static_cast<std::uint32_t>(length));
+    m_keywords.emplace_back(lexeme::is_keyword_candidate(type) ? keyword_for(text(m_types.size() - 1)) : keyword::none);
+    note_import(m_types.size() - 1);
+    note_delimiter(m_types.size() - 1);
+}
+
+auto kdl::lib::token_tape::push_line(std::size_t offset) -> void
+{
+    m_line_starts.emplace_back(static_cast<std::uint32_t>(offset));
+}
+
+auto kdl::lib::token_tape::push_checkpoint(const lexer_state& state) -> void
+{
+    if (!m_checkpoints.empty() && m_checkpoints.back().state.cursor == state.cursor) {
+        return;
+    }
+    m_checkpoints.emplace_back(checkpoint { state, m_types.size(), m_line_starts.size() });
+}
+
+auto kdl::lib::token_tape::append(const token_tape& tape, std::size_t first, std::size_t last, std::ptrdiff_t shift) -> void
+{
+    // Append everything that the given tape recorded between two of its checkpoints. The tape must refer to the
+    // same source (or an edited version of it, in which case offsets are shifted) and follow on from this tape.
+    const auto& from = tape.m_checkpoints[first];
+    const auto& to = tape.m_checkpoints[last];
+    auto token_base = static_cast<std::ptrdiff_t>(m_types.size()) - static_cast<std::ptrdiff_t>(from.tokens);
+    auto line_base = static_cast<std::ptrdiff_t>(m_line_starts.size()) - static_cast<std::ptrdiff_t>(from.line_starts);
+
+    m_types.insert(m_types.end(), tape.m_types.begin() + from.tokens, tape.m_types.begin() + to.tokens);
+    m_lengths.insert(m_lengths.end(), tape.m_lengths.begin() + from.tokens, tape.m_lengths.begin() + to.tokens);
+    m_keywords.insert(m_keywords.end(), tape.m_keywords.begin() + from.tokens, tape.m_keywords.begin() + to.tokens);
+    for (auto i = from.tokens; i < to.tokens; ++i) {
+        m_offsets.emplace_back(static_cast<std::uint32_t>(tape.m_offsets[i] + shift));
+        note_import(static_cast<std::size_t>(static_cast<std::ptrdiff_t>(i) + token_base));
+        note_delimiter(static_cast<std::size_t>(static_cast<std::ptrdiff_t>(i) + token_base));
+    }
+    for (auto i = from.line_starts; i < to.line_starts; ++i) {
+        m_line_starts.emplace_back(static_cast<std::uint32_t>(tape.m_line_starts[i] + shift));
+    }
+
+    for (auto i = first; i <= last; ++i) {
+        auto cp = tape.m_checkpoints[i];
+        cp.state.cursor += shift;
+        cp.tokens += token_base;
+        cp.line_starts += line_base;
+        if (m_checkpoints.empty() || m_checkpoints.back().state.cursor < cp.state.cursor) {
+            m_checkpoints.emplace_back(cp);
+        }
+    }
+}
+
+auto kdl::lib::token_tape::note_import(std::size_t i) -> void
+{
+    if (i > 0 && type(i) == lexeme_type::string && m_keywords[i - 1] == keyword::import
+        && type(i - 1) == lexeme_type::directive)
+    {
+        m_imports.emplace_back(static_cast<std::uint32_t>(i));
+    }
+}
+
+auto kdl::lib::token_tape::note_delimiter(std::size_t i) -> void
+{
+    // Opening delimiters wait on a stack for the delimiter that closes them. A closing delimiter with nothing open
+    // is left unmatched.
+    m_matches.emplace_back(unmatched);
+    auto type = this->type(i);
+    auto kind = delimiter_kind(type);
+    if (kind == no_delimiter) {
+        return;
+    }
+
+    auto& open = m_open_delimiters[kind];
+    if (closing_delimiter(type) != lexeme_type::unknown) {
+        open.emplace_back(static_cast<std::uint32_t>(i));
+    }
+    else if (!open.empty()) {
+        m_matches[i] = open.back();
+        m_matches[open.back()] = static_cast<std::uint32_t>(i);
+        open.pop_back();
+    }
+}
+
+// MARK: - Serialization
+
+auto kdl::lib::token_tape::serialize() const -> std::string
+{
+    std::string out;
+    out.reserve(64 + m_types.size() * 14 + m_line_starts.size() * 4 + m_checkpoints.size() * sizeof(checkpoint));
+
+    write(out, tape_magic);
+    write(out, tape_version);
+    write(out, static_cast<std::uint64_t>(m_text.size()));
+    write(out, static_cast<std::uint64_t>(m_types.size()));
+    write(out, static_cast<std::uint64_t>(m_line_starts.size()));
+    write(out, static_cast<std::uint64_t>(m_checkpoints.size()));
+    write(out, static_cast<std::uint64_t>(m_imports.size()));
+
+    write(out, m_types);
+    write(out, m_offsets);
+    write(out, m_lengths);
+    write(out, m_keywords);
+    write(out, m_line_starts);
+    write(out, m_imports);
+    write(out, m_matches);
+
+    for (const auto& cp : m_checkpoints) {
+        write(out, static_cast<std::uint64_t>(cp.state.cursor));
+        write(out, static_cast<std::uint64_t>(cp.state.line_offset));
+        write(out, static_cast<std::uint64_t>(cp.state.expr_paren_balance));
+        write(out, static_cast<std::uint8_t>(cp.state.in_expr));
+        write(out, cp.state.inactive_conditions);
+        write(out, cp.state.condition_depth);
+        write(out, static_cast<std::uint64_t>(cp.tokens));
+        write(out, static_cast<std::uint64_t>(cp.line_starts));
+    }
+
+    return out;
+}
+
+auto kdl::lib::token_tape::deserialize(std::string_view data) -> bool
+{
+    // The tape is restored over the source that it is currently set to, which must be the source that was
+    // serialized. If the data is malformed, then the tape is left empty.
+    tape_reader reader { data };
+    std::uint32_t magic = 0;
+    std::uint32_t version = 0;
+    std::uint64_t text_size = 0;
+    std::uint64_t tokens = 0;
+    std::uint64_t lines = 0;
+    std::uint64_t checkpoints = 0;
+    std::uint64_t imports = 0;
+
+    auto valid = reader.read(magic) && magic == tape_magic
+        && reader.read(version) && version == tape_version
+        && reader.read(text_size) && text_size == m_text.size()
+        && reader.read(tokens) && reader.read(lines) && reader.read(checkpoints) && reader.read(imports)
+        && reader.read(m_types, tokens)
+        && reader.read(m_offsets, tokens)
+        && reader.read(m_lengths, tokens)
+        && reader.read(m_keywords, tokens)
+        && reader.read(m_line_starts, lines)
+        && reader.read(m_imports, imports)
+        && reader.read(m_matches, tokens);
+
+    for (auto& open : m_open_delimiters) {
+        open.clear();
+    }
+    m_checkpoints.clear();
+    for (std::uint64_t n = 0; valid && n < checkpoints; ++n) {
+        std::uint64_t cursor = 0, line_offset = 0, balance = 0, cp_tokens = 0, cp_lines = 0;
+        std::uint8_t in_expr = 0;
+        checkpoint cp;
+        valid = reader.read(cursor) && reader.read(line_offset) && reader.read(balance) && reader.read(in_expr)
+            && reader.read(cp.state.inactive_conditions) && reader.read(cp.state.condition_depth)
+            && reader.read(cp_tokens) && reader.read(cp_lines);
+        cp.state.cursor = static_cast<std::size_t>(cursor);
+        cp.state.line_offset = static_cast<std::size_t>(line_offset);
+        cp.state.expr_paren_balance = static_cast<std::size_t>(balance);
+        cp.state.in_expr = (in_expr != 0);
+        cp.tokens = static_cast<std::size_t>(cp_tokens);
+        cp.line_starts = static_cast<std::size_t>(cp_lines);
+        m_checkpoints.emplace_back(cp);
+    }
+
+    if (!valid || !reader.data.empty() || m_line_starts.empty()) {
+        reset(m_source);
+        return false;
+    }
+    return true;
+}
+
+// MARK: - Accessors
+
+auto kdl::lib::token_tape::source() const -> std::shared_ptr<source_file>
+{
+    return m_source;
+}
+
+auto kdl::lib::token_tape::size() const -> std::size_t
+{
+    return m_types.size();
+}
+
+auto kdl::lib::token_tape::empty() const -> bool
+{
+    return m_types.empty();
+}
+
+auto kdl::lib::token_tape::line_count() const -> std::size_t
+{
+    return m_line_starts.size();
+}
+
+auto kdl::lib::token_tape::checkpoints() const -> const std::vector<checkpoint>&
+{
+    return m_checkpoints;
+}
+
+auto kdl::lib::token_tape::imports() const -> const std::vector<std::uint32_t>&
+{
+    return m_imports;
+}
+
+auto kdl::lib::token_tape::type(std::size_t i) const -> lexeme_type
+{
+    return static_cast<lexeme_type>(m_types[i]);
+}
+
+auto kdl::lib::token_tape::offset(std::size_t i) const -> std::size_t
+{
+    return m_offsets[i];
+}
+
+auto kdl::lib::token_tape::length(std::size_t i) const -> std::size_t
+{
+    return m_lengths[i];
+}
+
+auto kdl::lib::token_tape::text(std::size_t i) const -> std::string_view
+{
+    auto type = this->type(i);
+    auto prefix = value_prefix(type);
+    return m_text.substr(m_offsets[i] + prefix, m_lengths[i] - prefix - value_suffix(type));
+}
+
+auto kdl::lib::token_tape::keyword(std::size_t i) const -> lib::keyword
+{
+    return m_keywords[i];
+}
+
+auto kdl::lib::token_tape::line(std::size_t i) const -> std::size_t
+{
+    auto it = std::upper_bound(m_line_starts.begin(), m_line_starts.end(), m_offsets[i]);
+    return static_cast<std::size_t>(it - m_line_starts.begin());
+}
+
+auto kdl::lib::token_tape::column(std::size_t i) const -> std::size_t
+{
+    return m_offsets[i] - m_line_starts[line(i) - 1];
+}
+
+auto kdl::lib::token_tape::match(std::size_t i) const -> std::optional<std::size_t>
+{
+    if (m_matches[i] == unmatched) {
+        return {};
+    }
+    return m_matches[i];
+}
+
+// MARK: - Lexemes
+
+auto kdl::lib::token_tape::lexeme_at(std::size_t i) const -> lexeme
+{
+    auto type = this->type(i);
+    auto offset = this->offset(i);
+    auto length = this->length(i);
+    auto prefix = value_prefix(type);
+
+    return {
+        type, { m_source, offset, length },
+        offset + prefix, length - prefix - value_suffix(type)
+    };
+}
@@ -0,0 +1,113 @@
+// Copyright (c) 2021 Tom Hancocks
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <optional>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <kdl/file/source_file.hpp>
+#include <kdl/lexer/lexeme.hpp>
+#include <kdl/lexer/lexer_state.hpp>
+
+namespace kdl::lib
+{
+    /* A compact representation of the lexemes of a single source file. Rather than storing a lexeme structure per
+     * token, the tape stores the type, offset and length of each token in parallel arrays, alongside a table of
+     * the offsets at which each line of the source file begins.
+     *
+     * The offset and length of a token cover the entire token as it appears in the source (including any leading
+     * sigil, such as '@' or '#'), from which the value of the token can be derived. Identifiers and directives
+     * are tagged with their keyword as they are recorded. Full lexemes are only constructed when they are requested.
+     * The string tokens that follow an @import directive are also noted, so that imported files can be found without
+     * parsing the tape. Each brace, parenthesis or bracket is paired with the delimiter that matches it, so that a
+     * whole block can be skipped without walking through its tokens.
+     *
+     * The tape also holds periodic checkpoints of the lexer's state, from which scanning can be resumed. The first
+     * checkpoint is always where scanning began, and the last is where it ended.
+     *
+     * A tape can be reset to record a different source, keeping the storage that it has already allocated.
+     *
+     * A tape can be serialized to bytes, and restored from them for the same source. The serialized form uses the
+     * byte order of the host, and is only intended for caching tapes on the machine that produced them.
+     */
+    class token_tape
+    {
+    public:
+        struct checkpoint
+        {
+            lexer_state state;
+            std::size_t tokens { 0 };
+            std::size_t line_starts { 1 };
+        };
+
+    public:
+        explicit token_tape(std::shared_ptr<source_file> source);
+
+        auto reset(std::shared_ptr<source_file> source) -> void;
+
+        auto push(lexeme_type type, std::size_t offset, std::size_t length) -> void;
+        auto push_line(std::size_t offset) -> void;
+        auto push_checkpoint(const lexer_state& state) -> void;
+        auto append(const token_tape& tape, std::size_t first, std::size_t last, std::ptrdiff_t shift = 0) -> void;
+
+        [[nodiscard]] auto serialize() const -> std::string;
+        auto deserialize(std::string_view data) -> bool;
+
+        [[nodiscard]] auto source() const -> std::shared_ptr<source_file>;
+        [[nodiscard]] auto size() const -> std::size_t;
+        [[nodiscard]] auto empty() const -> bool;
+        [[nodiscard]] auto line_count() const -> std::size_t;
+        [[nodiscard]] auto checkpoints() const -> const std::vector<checkpoint>&;
+        [[nodiscard]] auto imports() const -> const std::vector<std::uint32_t>&;
+
+        [[nodiscard]] auto type(std::size_t i) const -> lexeme_type;
+        [[nodiscard]] auto offset(std::size_t i) const -> std::size_t;
+        [[nodiscard]] auto length(std::size_t i) const -> std::size_t;
+        [[nodiscard]] auto text(std::size_t i) const -> std::string_view;
+        [[nodiscard]] auto keyword(std::size_t i) const -> lib::keyword;
+        [[nodiscard]] auto line(std::size_t i) const -> std::size_t;
+        [[nodiscard]] auto column(std::size_t i) const -> std::size_t;
+        [[nodiscard]] auto match(std::size_t i) const -> std::optional<std::size_t>;
+
+        [[nodiscard]] auto lexeme_at(std::size_t i) const -> lexeme;
+
+    private:
+        auto note_import(std::size_t i) -> void;
+        auto note_delimiter(std::size_t i) -> void;
+
+    private:
+        std::shared_ptr<source_file> m_source;
+        std::string_view m_text;
+        std::vector<std::uint8_t> m_types;
+        std::vector<std::uint32_t> m_offsets;
+        std::vector<std::uint32_t> m_lengths;
+        std::vector<lib::keyword> m_keywords;
+        std::vector<std::uint32_t> m_line_starts {{ 0 }};
+        std::vector<checkpoint> m_checkpoints;
+        std::vector<std::uint32_t> m_imports;
+        std::vector<std::uint32_t> m_matches;
+        std::array<std::vector<std::uint32_t>, 3> m_open_delimiters;
+    };
+}
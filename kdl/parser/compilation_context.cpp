@@ -0,0 +1,64 @@
+// Copyright (c) 2021 Tom Hancocks
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <kdl/parser/compilation_context.hpp>
+#include <kdl/lexer/source_registry.hpp>
+
+// MARK: - Construction
+
+kdl::lib::compilation_context::compilation_context()
+    : m_lexer(std::make_shared<source_file>("")),
+      m_tape(std::make_shared<token_tape>(std::make_shared<source_file>("")))
+{
+
+}
+
+// MARK: - Configuration
+
+auto kdl::lib::compilation_context::set_flags(const std::vector<std::string>& flags) -> void
+{
+    m_lexer.set_flags(flags);
+}
+
+// MARK: - Compilation
+
+auto kdl::lib::compilation_context::compile(const std::shared_ptr<source_file>& source) -> parse_result
+{
+    // The parser lets go of the previous tape first. If anything else is still holding on to it, then a new tape
+    // is needed, as the old one can not be overwritten.
+    m_parser.release();
+    if (m_tape.use_count() > 1) {
+        m_tape = std::make_shared<token_tape>(source);
+    }
+
+    m_lexer.set_source(source);
+    m_lexer.scan_tape(*m_tape);
+    source_registry::shared().prefetch_imports(*m_tape);
+
+    m_parser.parse(std::shared_ptr<const token_tape>(m_tape));
+    return m_parser.result();
+}
+
+auto kdl::lib::compilation_context::release_buffers() -> void
+{
+    m_parser = parser();
+    m_tape = std::make_shared<token_tape>(std::make_shared<source_file>(""));
+    m_lexer.set_source(m_tape->source());
+}
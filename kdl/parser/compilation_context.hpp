@@ -0,0 +1,58 @@
+// Copyright (c) 2021 Tom Hancocks
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#if !defined(KDL_PARSER_COMPILATION_CONTEXT_HPP)
+#define KDL_PARSER_COMPILATION_CONTEXT_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <kdl/file/source_file.hpp>
+#include <kdl/lexer/lexer.hpp>
+#include <kdl/lexer/token_tape.hpp>
+#include <kdl/parser/parser.hpp>
+#include <kdl/parser/result.hpp>
+
+namespace kdl::lib
+{
+    /* A compilation context holds on to a lexer, a token tape and a parser between compiles, so that tools which
+     * compile repeatedly (such as compiling on save, or compiling a batch of projects) reuse their buffers rather
+     * than allocating new ones for each compile. Only the contents of the buffers are cleared between compiles.
+     *
+     * The schema produced by each compile is always newly allocated, and remains valid after the next compile.
+     */
+    class compilation_context
+    {
+    public:
+        compilation_context();
+
+        auto set_flags(const std::vector<std::string>& flags) -> void;
+
+        auto compile(const std::shared_ptr<source_file>& source) -> parse_result;
+        auto release_buffers() -> void;
+
+    private:
+        lexer m_lexer;
+        std::shared_ptr<token_tape> m_tape;
+        parser m_parser;
+    };
+}
+
+#endif //KDL_PARSER_COMPILATION_CONTEXT_HPP
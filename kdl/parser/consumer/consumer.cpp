@@ -18,15 +18,210 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <stdexcept>
+#include <algorithm>
 #include <kdl/parser/consumer/consumer.hpp>
 #include <kdl/report/reporting.hpp>
 
 // MARK: - Construction
 
 kdl::lib::lexeme_consumer::lexeme_consumer(std::vector<lexeme> lexemes)
-    : m_lexemes(std::move(lexemes)), m_cursor(0)
+    : m_cursor(0)
 {
+    segment seg;
+    seg.lexemes.assign(std::make_move_iterator(lexemes.begin()), std::make_move_iterator(lexemes.end()));
+    m_size = seg.size();
+    m_segments.emplace_back(std::move(seg));
+}
+
+kdl::lib::lexeme_consumer::lexeme_consumer(std::shared_ptr<lexer> source)
+    : m_cursor(0)
+{
+    segment seg;
+    seg.source = std::move(source);
+    m_segments.emplace_back(std::move(seg));
+}
+
+kdl::lib::lexeme_consumer::lexeme_consumer(std::shared_ptr<const token_tape> tape)
+    : m_cursor(0)
+{
+    reset(std::move(tape));
+}
 
+auto kdl::lib::lexeme_consumer::reset(std::shared_ptr<const token_tape> tape) -> void
+{
+    m_position_stack.clear();
+    m_segments.clear();
+    m_size = 0;
+    if (tape) {
+        segment seg;
+        seg.end = tape->size();
+        seg.tape = std::move(tape);
+        m_size = seg.size();
+        m_segments.emplace_back(std::move(seg));
+    }
+    m_pushed_lexemes.clear();
+    m_cursor = 0;
+    m_previous_expect_result = false;
+}
+
+// MARK: - Streaming
+
+auto kdl::lib::lexeme_consumer::buffer(std::int64_t size) const -> void
+{
+    // Pull lexemes from the source until the requested number of lexemes are buffered, or the source is exhausted.
+    // Only the last segment can have a source.
+    while (!m_segments.empty() && m_segments.back().source && static_cast<std::int64_t>(m_size) < size) {
+        auto& seg = m_segments.back();
+        if (auto lx = seg.source->next()) {
+            seg.lexemes.emplace_back(std::move(*lx));
+            ++m_size;
+        }
+        else {
+            seg.source.reset();
+        }
+    }
+}
+
+auto kdl::lib::lexeme_consumer::discard_consumed() -> void
+{
+    // Lexemes can only be released if nothing is going to backtrack to them. At least one lexeme is always retained
+    // so that errors at the end of the stream have something to be reported against.
+    if (!m_position_stack.empty() || m_cursor == 0 || m_size == 0) {
+        return;
+    }
+
+    auto count = std::min(m_cursor, m_size) - 1;
+    auto discarded = count;
+    while (count > 0 && !m_segments.empty()) {
+        auto& seg = m_segments.front();
+        auto size = seg.size();
+        if (size <= count && !seg.source) {
+            count -= size;
+            m_segments.pop_front();
+            continue;
+        }
+
+        auto from_lexemes = std::min(count, seg.lexemes.size());
+        seg.lexemes.erase(seg.lexemes.begin(), seg.lexemes.begin() + static_cast<std::ptrdiff_t>(from_lexemes));
+        seg.next += count - from_lexemes;
+        count = 0;
+    }
+
+    m_cursor -= discarded;
+    m_size -= discarded;
+}
+
+// MARK: - Segments
+
+auto kdl::lib::lexeme_consumer::locate(std::size_t i) const -> location
+{
+    // The segments before the cursor are discarded regularly, so the segment holding a lexeme near the cursor is
+    // found after only a few steps.
+    for (auto& seg : m_segments) {
+        auto size = seg.size();
+        if (i < size) {
+            return { &seg, i };
+        }
+        i -= size;
+    }
+    return {};
+}
+
+auto kdl::lib::lexeme_consumer::split(std::size_t i) -> std::list<segment>::iterator
+{
+    // Split the segment containing position i, so that i is the start of a segment, and return that segment. The
+    // end of the list is returned if i is the end of the stream.
+    for (auto it = m_segments.begin(); it != m_segments.end(); ++it) {
+        auto size = it->size();
+        if (i == 0) {
+            return it;
+        }
+        if (i >= size) {
+            i -= size;
+            continue;
+        }
+
+        segment tail;
+        tail.tape = it->tape;
+        tail.end = it->end;
+        tail.source = std::move(it->source);
+        if (i < it->lexemes.size()) {
+            auto first = it->lexemes.begin() + static_cast<std::ptrdiff_t>(i);
+            tail.lexemes.assign(std::make_move_iterator(first), std::make_move_iterator(it->lexemes.end()));
+            it->lexemes.erase(first, it->lexemes.end());
+            tail.next = it->next;
+            it->next -= tail.lexemes.size();
+            it->end = it->next;
+        }
+        else {
+            tail.next = it->next + (i - it->lexemes.size());
+            it->end = tail.next;
+        }
+        return m_segments.insert(std::next(it), std::move(tail));
+    }
+    return m_segments.end();
+}
+
+auto kdl::lib::lexeme_consumer::link(segment seg, std::int32_t offset) -> void
+{
+    // When the insertion point is beyond the end of the stream, the lexemes are added to the end of it.
+    auto position = finished(1, offset) ? stream_size() : m_cursor + offset;
+    m_size += seg.size();
+    m_segments.insert(split(position), std::move(seg));
+}
+
+auto kdl::lib::lexeme_consumer::stream_size() const -> std::size_t
+{
+    return m_size;
+}
+
+auto kdl::lib::lexeme_consumer::lexeme_at(std::size_t i) const -> const lexeme&
+{
+    // Tokens are constructed from the tape in order, so that the constructed lexemes of each segment remain a prefix
+    // of it.
+    auto loc = locate(i);
+    auto& seg = *loc.seg;
+    while (seg.lexemes.size() <= loc.index) {
+        seg.lexemes.emplace_back(seg.tape->lexeme_at(seg.next++));
+    }
+    return seg.lexemes[loc.index];
+}
+
+auto kdl::lib::lexeme_consumer::type_at(std::size_t i) const -> lexeme_type
+{
+    auto loc = locate(i);
+    if (loc.index < loc.seg->lexemes.size()) {
+        return loc.seg->lexemes[loc.index].type();
+    }
+    return loc.seg->tape->type(loc.seg->next + loc.index - loc.seg->lexemes.size());
+}
+
+auto kdl::lib::lexeme_consumer::keyword_at(std::size_t i) const -> keyword
+{
+    auto loc = locate(i);
+    if (loc.index < loc.seg->lexemes.size()) {
+        return loc.seg->lexemes[loc.index].keyword();
+    }
+    return loc.seg->tape->keyword(loc.seg->next + loc.index - loc.seg->lexemes.size());
+}
+
+auto kdl::lib::lexeme_consumer::text_at(std::size_t i) const -> std::string_view
+{
+    auto loc = locate(i);
+    if (loc.index < loc.seg->lexemes.size()) {
+        return loc.seg->lexemes[loc.index].text();
+    }
+    return loc.seg->tape->text(loc.seg->next + loc.index - loc.seg->lexemes.size());
+}
+
+auto kdl::lib::lexeme_consumer::matches(const expect::function& expectation, std::int32_t offset) const -> bool
+{
+    if (!m_pushed_lexemes.empty() || finished(1, offset)) {
+        return expectation(peek(offset));
+    }
+    auto i = m_cursor + offset;
+    return expectation(type_at(i), keyword_at(i), text_at(i));
 }
 
 // MARK: - Lexeme Management
@@ -35,18 +230,24 @@ auto kdl::lib::lexeme_consumer::finished(std::size_t count, std::int32_t offset)
 {
     auto cursor = m_cursor + offset;
     auto end = cursor + count;
-    auto size = m_lexemes.size();
+    buffer(static_cast<std::int64_t>(end));
+    auto size = stream_size();
     return (cursor > size) || (end > size);
 }
 
 auto kdl::lib::lexeme_consumer::has_available(std::size_t count, std::int32_t offset) const -> bool
 {
-    return (m_cursor + offset + count) < m_lexemes.size();
+    buffer(static_cast<std::int64_t>(m_cursor + offset + count) + 1);
+    return (m_cursor + offset + count) < stream_size();
 }
 
-auto kdl::lib::lexeme_consumer::at(std::size_t i) const -> lexeme
+auto kdl::lib::lexeme_consumer::at(std::size_t i) const -> const lexeme&
 {
-    return m_lexemes.at(i);
+    buffer(static_cast<std::int64_t>(i) + 1);
+    if (i >= stream_size()) {
+        throw std::out_of_range("Attempted to access lexeme beyond end of stream.");
+    }
+    return lexeme_at(i);
 }
 
 auto kdl::lib::lexeme_consumer::save_position() -> void
@@ -65,8 +266,9 @@ auto kdl::lib::lexeme_consumer::restore_position() -> void
 
 auto kdl::lib::lexeme_consumer::advance(std::int32_t offset) -> void
 {
-    for (auto n = 0; !m_pushed_lexemes.empty() && n < offset; ++n) {
-        m_pushed_lexemes.erase(m_pushed_lexemes.begin());
+    // Pushed lexemes sit in front of the cursor, so they are used up before the stream itself is advanced.
+    while (!m_pushed_lexemes.empty() && offset > 0) {
+        m_pushed_lexemes.pop_front();
         offset--;
     }
     m_cursor += offset;
@@ -74,13 +276,18 @@ auto kdl::lib::lexeme_consumer::advance(std::int32_t offset) -> void
 
 auto kdl::lib::lexeme_consumer::insert(std::vector<lexeme> lx, std::int32_t offset) -> void
 {
-    if (finished(1, offset)) {
-        m_lexemes.insert(m_lexemes.end(), lx.begin(), lx.end());
-    }
-    else {
-        auto ptr = m_lexemes.begin() + static_cast<decltype(offset)>(m_cursor) + offset;
-        m_lexemes.insert(ptr, lx.begin(), lx.end());
-    }
+    segment seg;
+    seg.lexemes.assign(std::make_move_iterator(lx.begin()), std::make_move_iterator(lx.end()));
+    link(std::move(seg), offset);
+}
+
+auto kdl::lib::lexeme_consumer::insert(std::shared_ptr<const token_tape> tape, std::int32_t offset) -> void
+{
+    // The tape is linked in to the stream as it is. Its lexemes are constructed as they are read.
+    segment seg;
+    seg.end = tape->size();
+    seg.tape = std::move(tape);
+    link(std::move(seg), offset);
 }
 
 auto kdl::lib::lexeme_consumer::push_lexemes(std::initializer_list<lexeme> lexemes, size_t offset) -> void
@@ -90,7 +297,8 @@ auto kdl::lib::lexeme_consumer::push_lexemes(std::initializer_list<lexeme> lexem
 
 auto kdl::lib::lexeme_consumer::push_lexemes(std::vector<lexeme> lexemes, size_t offset) -> void
 {
-    m_pushed_lexemes.insert(m_pushed_lexemes.begin(), m_lexemes.begin(), m_lexemes.end());
+    auto position = m_pushed_lexemes.begin() + static_cast<std::ptrdiff_t>(std::min(offset, m_pushed_lexemes.size()));
+    m_pushed_lexemes.insert(position, std::make_move_iterator(lexemes.begin()), std::make_move_iterator(lexemes.end()));
 }
 
 auto kdl::lib::lexeme_consumer::drop_lexemes() -> void
@@ -98,35 +306,97 @@ auto kdl::lib::lexeme_consumer::drop_lexemes() -> void
     m_pushed_lexemes.clear();
 }
 
-auto kdl::lib::lexeme_consumer::peek(std::int32_t offset) const -> lexeme
+auto kdl::lib::lexeme_consumer::peek(std::int32_t offset) const -> const lexeme&
 {
-    if (!m_pushed_lexemes.empty() && (offset >= 0 || offset < m_pushed_lexemes.size())) {
-        return m_pushed_lexemes.at(offset);
+    if (!m_pushed_lexemes.empty() && offset >= 0) {
+        if (static_cast<std::size_t>(offset) < m_pushed_lexemes.size()) {
+            return m_pushed_lexemes[offset];
+        }
+        offset -= static_cast<std::int32_t>(m_pushed_lexemes.size());
     }
     if (finished(1, offset)) {
-        report::error(m_lexemes.at(m_lexemes.size() - 1), "Attempted to access lexeme beyond end of stream.");
+        report::error(lexeme_at(stream_size() - 1), "Attempted to access lexeme beyond end of stream.");
+    }
+    return lexeme_at(m_cursor + offset);
+}
+
+auto kdl::lib::lexeme_consumer::peek_type(std::int32_t offset) const -> lexeme_type
+{
+    if (!m_pushed_lexemes.empty() || finished(1, offset)) {
+        return peek(offset).type();
     }
-    return m_lexemes.at(m_cursor + offset);
+    return type_at(m_cursor + offset);
 }
 
-auto kdl::lib::lexeme_consumer::read(std::int32_t offset) -> lexeme
+auto kdl::lib::lexeme_consumer::read(std::int32_t offset) -> const lexeme&
 {
-    auto lx = peek(offset);
-    if (m_pushed_lexemes.empty() || (offset >= m_pushed_lexemes.size())) {
+    if (m_pushed_lexemes.empty() || offset < 0 || (static_cast<std::size_t>(offset) >= m_pushed_lexemes.size())) {
+        const auto& lx = peek(offset);
         advance(offset + 1);
+        return lx;
     }
-    else {
-        for (auto n = 0; n <= offset; ++n) {
-            m_pushed_lexemes.erase(m_pushed_lexemes.begin());
+
+    // Pushed lexemes are removed as they are read, so the lexeme is kept aside until the next one is read.
+    advance(offset);
+    m_pushed_read = std::move(m_pushed_lexemes.front());
+    m_pushed_lexemes.pop_front();
+    return m_pushed_read;
+}
+
+auto kdl::lib::lexeme_consumer::slice(std::int32_t offset, std::size_t count) const -> std::vector<lexeme>
+{
+    std::vector<lexeme> v;
+    v.reserve(count);
+    for (std::size_t n = 0; n < count; ++n) {
+        v.emplace_back(peek(offset + static_cast<std::int32_t>(n)));
+    }
+    return v;
+}
+
+auto kdl::lib::lexeme_consumer::matching_delimiter(std::int32_t offset) const -> std::optional<std::int32_t>
+{
+    auto pushed = static_cast<std::int32_t>(m_pushed_lexemes.size());
+    auto available = [&] (std::int32_t n) {
+        return (n >= 0 && n < pushed) || !finished(1, (n >= 0) ? n - pushed : n);
+    };
+    if (!available(offset) || closing_delimiter(peek_type(offset)) == lexeme_type::unknown) {
+        return {};
+    }
+
+    // The constructed lexemes of a segment are the tokens of its tape that come immediately before the next token
+    // to construct, so the position of a lexeme in the tape is known. The match is only used if it is in the same
+    // segment, as the stream will differ from the tape if anything has been inserted in to the block.
+    if (m_pushed_lexemes.empty()) {
+        auto loc = locate(m_cursor + offset);
+        if (loc.seg && loc.seg->tape) {
+            auto index = loc.seg->next - loc.seg->lexemes.size() + loc.index;
+            auto match = loc.seg->tape->match(index);
+            if (match && *match > index && *match < loc.seg->end) {
+                return offset + static_cast<std::int32_t>(*match - index);
+            }
+        }
+    }
+
+    // Otherwise walk the block, pairing delimiters of the same kind in the same way that the tape does.
+    auto opening = peek_type(offset);
+    auto closing = closing_delimiter(opening);
+    std::size_t depth = 0;
+    for (auto n = offset; available(n); ++n) {
+        auto type = peek_type(n);
+        if (type == opening) {
+            depth++;
+        }
+        else if (type == closing && --depth == 0) {
+            return n;
         }
     }
-    return lx;
+    return {};
 }
 
 auto kdl::lib::lexeme_consumer::consume(const expect::function& expectation) -> std::vector<lexeme>
 {
     std::vector<lexeme> v;
-    while (!finished() && expectation(peek())) {
+    while (!finished() && matches(expectation, 0)) {
         v.emplace_back(read());
     }
     return v;
@@ -136,32 +406,41 @@ auto kdl::lib::lexeme_consumer::consume(const expect::function& expectation) ->
 
 auto kdl::lib::lexeme_consumer::expect(const expect::function& expectation) -> bool
 {
-    return (m_previous_expect_result = expectation(peek()));
+    return (m_previous_expect_result = matches(expectation, 0));
 }
 
 auto kdl::lib::lexeme_consumer::expect_any(std::initializer_list<expect::function> expectations) -> bool
 {
-    return expect_any(std::vector(expectations));
+    return (m_previous_expect_result = std::any_of(expectations.begin(), expectations.end(), [&] (const expect::function& expectation) {
+        return matches(expectation, 0);
+    }));
 }
 
 auto kdl::lib::lexeme_consumer::expect_any(std::vector<expect::function> expectations) -> bool
 {
-    auto lx = peek();
-    return (m_previous_expect_result = std::any_of(expectations.begin(), expectations.end(), [expectations, lx] (const expect::function& expectation) {
-        return expectation(lx);
+    return (m_previous_expect_result = std::any_of(expectations.begin(), expectations.end(), [&] (const expect::function& expectation) {
+        return matches(expectation, 0);
     }));
 }
 
 auto kdl::lib::lexeme_consumer::expect_all(std::initializer_list<expect::function> expectations) -> bool
 {
-    return expect_all(std::vector(expectations));
+    m_previous_expect_result = true;
+    std::int32_t n = 0;
+    for (const auto& expectation : expectations) {
+        if (!matches(expectation, n++)) {
+            m_previous_expect_result = false;
+            break;
+        }
+    }
+    return m_previous_expect_result;
 }
 
 auto kdl::lib::lexeme_consumer::expect_all(std::vector<expect::function> expectations) -> bool
 {
     m_previous_expect_result = true;
     for (auto n = 0; n < expectations.size(); ++n) {
-        if (!expectations.at(n)(peek(n))) {
+        if (!matches(expectations.at(n), n)) {
             m_previous_expect_result = false;
             break;
         }
@@ -174,10 +453,15 @@ auto kdl::lib::lexeme_consumer::validate_expect() const -> bool
     return m_previous_expect_result;
 }
 
+auto kdl::lib::lexeme_consumer::report_invalid_sequence() const -> void
+{
+    report::error(peek(), "Invalid sequence of lexemes encountered.");
+}
+
 auto kdl::lib::lexeme_consumer::assert_lexemes(std::initializer_list<expect::function> expectations) -> void
 {
-    if (!expect_all(std::vector(expectations))) {
-        report::error(peek(), "Invalid sequence of lexemes encountered.");
+    if (!expect_all(expectations)) {
+        report_invalid_sequence();
     }
     advance(static_cast<std::int32_t>(expectations.size()));
 }
\ No newline at end of file
@@ -21,43 +21,121 @@
 #if !defined(KDL_PARSER_CONSUMER_HPP)
 #define KDL_PARSER_CONSUMER_HPP
 
+#include <deque>
+#include <list>
 #include <vector>
+#include <memory>
+#include <optional>
 #include <initializer_list>
 #include <kdl/lexer/lexeme.hpp>
+#include <kdl/lexer/lexer.hpp>
+#include <kdl/lexer/token_tape.hpp>
 #include <kdl/parser/consumer/expect.hpp>
+#include <kdl/parser/consumer/pattern.hpp>
 
 namespace kdl::lib
 {
 
+    /* The consumer can either be given a complete vector of lexemes, a token tape, or a lexer from which lexemes are
+     * pulled as they are needed. When pulling from a lexer, lexemes that have already been consumed can be released
+     * with discard_consumed(), so that only a small window of lexemes is held at any one time.
+     *
+     * When reading from a token tape, lexemes are only constructed when they are actually read. Expectations are
+     * tested directly against the types and text recorded in the tape.
+     *
+     * The stream is held as a list of segments, each of which is a range of a token tape, a run of lexemes, or the
+     * lexer that lexemes are being pulled from. Inserting in to the stream (for instance when importing a file)
+     * splits the segment at the insertion point and links the new segment in between, so the cost of an insertion
+     * does not depend on the number of lexemes that follow it.
+     *
+     * Expectations are usually given as compile time patterns (see pattern.hpp), for instance
+     * expect<pattern::seq<pattern::identifier, pattern::equals>>(), which test the type and keyword of each token
+     * directly. The expect::function forms are kept for expectations that are only known at run time.
+     *
+     * peek(), read() and at() hand out references to the lexemes held by the consumer, rather than copies. Lexemes
+     * that are read from a token tape are constructed once and kept in the buffer. A reference remains valid until
+     * the stream is modified, by insert() or discard_consumed(), so anything that needs a lexeme for longer must
+     * copy it.
+     *
+     * A consumer can be reset to read from a new token tape, keeping the storage of its position stack.
+     */
     class lexeme_consumer
     {
     private:
+        /* The lexemes of a segment that have been constructed, followed by the tokens [next, end) of its tape that
+         * have not been, followed by anything that its lexer has yet to produce.
+         */
+        struct segment
+        {
+            std::deque<lexeme> lexemes;
+            std::shared_ptr<const token_tape> tape;
+            std::size_t next { 0 };
+            std::size_t end { 0 };
+            std::shared_ptr<lexer> source;
+
+            [[nodiscard]] auto size() const -> std::size_t { return lexemes.size() + (end - next); }
+        };
+
+        struct location
+        {
+            segment *seg { nullptr };
+            std::size_t index { 0 };
+        };
+
         std::vector<std::size_t> m_position_stack;
-        std::vector<lexeme> m_lexemes;
-        std::vector<lexeme> m_pushed_lexemes;
+        mutable std::list<segment> m_segments;
+        mutable std::size_t m_size { 0 };
+        std::deque<lexeme> m_pushed_lexemes;
+        lexeme m_pushed_read;
         std::size_t m_cursor { 0 };
         bool m_previous_expect_result { false };
 
+        auto buffer(std::int64_t size) const -> void;
+        [[nodiscard]] auto locate(std::size_t i) const -> location;
+        auto split(std::size_t i) -> std::list<segment>::iterator;
+        auto link(segment seg, std::int32_t offset) -> void;
+        [[nodiscard]] auto stream_size() const -> std::size_t;
+        [[nodiscard]] auto lexeme_at(std::size_t i) const -> const lexeme&;
+        [[nodiscard]] auto type_at(std::size_t i) const -> lexeme_type;
+        [[nodiscard]] auto keyword_at(std::size_t i) const -> keyword;
+        [[nodiscard]] auto text_at(std::size_t i) const -> std::string_view;
+        [[nodiscard]] auto matches(const expect::function& expectation, std::int32_t offset) const -> bool;
+        [[noreturn]] auto report_invalid_sequence() const -> void;
+
     public:
         explicit lexeme_consumer(std::vector<lexeme> lexemes);
+        explicit lexeme_consumer(std::shared_ptr<lexer> source);
+        explicit lexeme_consumer(std::shared_ptr<const token_tape> tape);
+
+        auto reset(std::shared_ptr<const token_tape> tape) -> void;
 
         [[nodiscard]] auto finished(std::size_t count = 1, std::int32_t offset = 0) const -> bool;
         [[nodiscard]] auto has_available(std::size_t count = 1, std::int32_t offset = 0) const -> bool;
-        [[nodiscard]] auto at(std::size_t i) const -> lexeme;
+        [[nodiscard]] auto at(std::size_t i) const -> const lexeme&;
 
         auto save_position() -> void;
         auto restore_position() -> void;
 
         auto advance(std::int32_t offset = 1) -> void;
+        auto discard_consumed() -> void;
 
         auto insert(std::vector<lexeme> lx, std::int32_t offset = 0) -> void;
+        auto insert(std::shared_ptr<const token_tape> tape, std::int32_t offset = 0) -> void;
         auto push_lexemes(std::initializer_list<lexeme> lexemes, size_t offset = 0) -> void;
         auto push_lexemes(std::vector<lexeme> lexemes, size_t offset = 0) -> void;
         auto drop_lexemes() -> void;
 
-        [[nodiscard]] auto peek(std::int32_t offset = 0) const -> lexeme;
-        auto read(std::int32_t offset = 0) -> lexeme;
+        [[nodiscard]] auto peek(std::int32_t offset = 0) const -> const lexeme&;
+        [[nodiscard]] auto peek_type(std::int32_t offset = 0) const -> lexeme_type;
+        auto read(std::int32_t offset = 0) -> const lexeme&;
         auto consume(const expect::function& expectation) -> std::vector<lexeme>;
+        [[nodiscard]] auto slice(std::int32_t offset, std::size_t count) const -> std::vector<lexeme>;
+
+        /* Find the delimiter that closes the brace, parenthesis or bracket at the given offset, and return its offset.
+         * Lexemes read from a token tape have their delimiters paired already, so whole blocks can be skipped without
+         * reading through them.
+         */
+        [[nodiscard]] auto matching_delimiter(std::int32_t offset = 0) const -> std::optional<std::int32_t>;
 
         auto expect(const expect::function& expectation) -> bool;
         auto expect_any(std::initializer_list<expect::function> expectations) -> bool;
@@ -68,6 +146,42 @@ namespace kdl::lib
 
         auto assert_lexemes(std::initializer_list<expect::function> expectations) -> void;
 
+        template<typename Pattern>
+        auto expect() -> bool
+        {
+            return (m_previous_expect_result = Pattern::match(*this, 0));
+        }
+
+        template<typename Pattern>
+        auto assert_lexemes() -> void
+        {
+            if (!expect<Pattern>()) {
+                report_invalid_sequence();
+            }
+            advance(static_cast<std::int32_t>(Pattern::length));
+        }
+
+        template<typename Pattern>
+        auto consume() -> std::vector<lexeme>
+        {
+            std::vector<lexeme> v;
+            while (!finished() && Pattern::match(*this, 0)) {
+                v.emplace_back(read());
+            }
+            return v;
+        }
+
+        template<typename Token>
+        [[nodiscard]] auto test_token(std::int32_t offset) const -> bool
+        {
+            if (!m_pushed_lexemes.empty() || finished(1, offset)) {
+                const auto& lx = peek(offset);
+                return Token::test(lx.type(), lx.keyword(), lx.text());
+            }
+            auto i = m_cursor + offset;
+            return Token::test(type_at(i), keyword_at(i), text_at(i));
+        }
+
     };
 
 }
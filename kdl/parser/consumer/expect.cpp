@@ -29,34 +29,61 @@ kdl::lib::expect::expect(lexeme_type type)
 }
 
 kdl::lib::expect::expect(std::string value)
-    : m_value(std::move(value)), m_type(lexeme_type::unknown)
+    : m_value(std::move(value)), m_type(lexeme_type::unknown), m_keyword(keyword_for(m_value))
 {
 
 }
 
 kdl::lib::expect::expect(lexeme_type type, std::string value)
-    : m_value(std::move(value)), m_type(type)
+    : m_value(std::move(value)), m_type(type), m_keyword(keyword_for(m_value))
 {
 
 }
 
-// MARK: - Functions
+kdl::lib::expect::expect(lexeme_type type, keyword kw)
+    : m_type(type), m_keyword(kw)
+{
 
-auto kdl::lib::expect::to_be(bool match) const -> function
+}
+
+kdl::lib::expect::function::function(lexeme_type type, std::string value, keyword kw, bool match)
+    : m_type(type), m_value(std::move(value)), m_keyword(kw), m_match(match)
 {
-    return [&, match] (const lexeme& lx) -> bool {
-        auto outcome = true;
 
-        if (!this->m_value.empty() && !lx.is(this->m_value)) {
-            outcome = false;
-        }
+}
+
+// MARK: - Evaluation
 
-        if (this->m_type != lexeme_type::unknown && !lx.is(this->m_type)) {
+auto kdl::lib::expect::function::operator()(const lexeme& lx) const -> bool
+{
+    return (*this)(lx.type(), lx.keyword(), lx.text());
+}
+
+auto kdl::lib::expect::function::operator()(lexeme_type type, keyword kw, std::string_view text) const -> bool
+{
+    auto outcome = true;
+
+    if (m_keyword != keyword::none) {
+        if (lexeme::is_keyword_candidate(type) ? (kw != m_keyword) : (text != keyword_name(m_keyword))) {
             outcome = false;
         }
+    }
+    else if (!m_value.empty() && text != m_value) {
+        outcome = false;
+    }
+
+    if (m_type != lexeme_type::unknown && !lexeme::type_matches(type, m_type)) {
+        outcome = false;
+    }
+
+    return (outcome == m_match);
+}
+
+// MARK: - Functions
 
-        return (outcome == match);
-    };
+auto kdl::lib::expect::to_be(bool match) const -> function
+{
+    return { m_type, m_value, m_keyword, match };
 }
 
 auto kdl::lib::expect::to_match() const -> function
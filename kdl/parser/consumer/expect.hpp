@@ -22,7 +22,7 @@
 #define KDL_PARSER_CONSUMER_EXPECT_HPP
 
 #include <string>
-#include <functional>
+#include <string_view>
 #include <kdl/lexer/lexeme.hpp>
 
 namespace kdl::lib
@@ -31,11 +31,29 @@ namespace kdl::lib
     struct expect
     {
     public:
-        typedef std::function<auto(const lexeme&)->bool> function;
+        /* An expectation can be tested against a full lexeme, or against just the type, keyword and text of a
+         * token, which allows it to be tested without constructing a lexeme at all. When the expected value is a
+         * keyword, identifiers and directives are matched by their keyword id rather than by their text.
+         */
+        class function
+        {
+        private:
+            lexeme_type m_type;
+            std::string m_value;
+            keyword m_keyword;
+            bool m_match;
+
+        public:
+            function(lexeme_type type, std::string value, keyword kw, bool match);
+
+            auto operator()(const lexeme& lx) const -> bool;
+            auto operator()(lexeme_type type, keyword kw, std::string_view text) const -> bool;
+        };
 
     private:
         lexeme_type m_type;
         std::string m_value;
+        keyword m_keyword { keyword::none };
 
         [[nodiscard]] auto to_be(bool match) const -> function;
 
@@ -43,6 +61,7 @@ namespace kdl::lib
         explicit expect(lexeme_type type);
         explicit expect(std::string value);
         expect(lexeme_type type, std::string value);
+        expect(lexeme_type type, keyword kw);
 
         [[nodiscard]] auto to_match() const -> function;
         [[nodiscard]] auto to_not_match() const -> function;
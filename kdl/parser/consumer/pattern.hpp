@@ -0,0 +1,143 @@
+// Copyright (c) 2021 Tom Hancocks
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#if !defined(KDL_PARSER_CONSUMER_PATTERN_HPP)
+#define KDL_PARSER_CONSUMER_PATTERN_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <kdl/lexer/lexeme_type.hpp>
+#include <kdl/lexer/lexeme.hpp>
+#include <kdl/lexer/keyword.hpp>
+
+namespace kdl::lib::pattern
+{
+    /* Patterns describe the tokens that the parser expects to see, entirely at compile time. A pattern is a type,
+     * so testing one against the lexeme consumer compiles down to comparisons of the token types and keyword ids,
+     * without constructing anything at run time.
+     *
+     *  token<T, K>     A single token of type T (and optionally the keyword K). A type of unknown matches any
+     *                  token.
+     *  ident<K>        An identifier for the keyword K.
+     *  directive<K>    A directive for the keyword K.
+     *  not_<P>         Anything that does not match P.
+     *  seq<P...>       Each pattern in turn, in consecutive tokens.
+     *  any<P...>       Any one of the patterns, at the same position.
+     *
+     * Every pattern has a length, which is the number of tokens that it spans, and is tested against a source
+     * (the lexeme consumer) at an offset from the current position.
+     */
+
+    template<lexeme_type Type, lib::keyword Keyword = lib::keyword::none>
+    struct token
+    {
+        static constexpr std::size_t length { 1 };
+
+        static constexpr auto test(lexeme_type type, lib::keyword kw, std::string_view text) -> bool
+        {
+            if constexpr (Keyword != lib::keyword::none) {
+                // Only identifiers and directives are tagged with keywords, anything else compares its text.
+                if (lexeme::is_keyword_candidate(type) ? (kw != Keyword) : (text != keyword_name(Keyword))) {
+                    return false;
+                }
+            }
+            if constexpr (Type != lexeme_type::unknown) {
+                return lexeme::type_matches(type, Type);
+            }
+            return true;
+        }
+
+        template<typename Source>
+        static auto match(const Source& source, std::int32_t offset) -> bool
+        {
+            return source.template test_token<token>(offset);
+        }
+    };
+
+    template<typename Pattern>
+    struct not_
+    {
+        static constexpr std::size_t length { Pattern::length };
+
+        template<typename Source>
+        static auto match(const Source& source, std::int32_t offset) -> bool
+        {
+            return !Pattern::match(source, offset);
+        }
+    };
+
+    template<typename... Patterns>
+    struct seq
+    {
+        static constexpr std::size_t length { (Patterns::length + ... + 0) };
+
+        template<typename Source>
+        static auto match(const Source& source, std::int32_t offset) -> bool
+        {
+            auto matched = true;
+            ((matched = matched && Patterns::match(source, offset), offset += static_cast<std::int32_t>(Patterns::length)), ...);
+            return matched;
+        }
+    };
+
+    template<typename... Patterns>
+    struct any
+    {
+        static constexpr std::size_t length { std::max({ Patterns::length... }) };
+
+        template<typename Source>
+        static auto match(const Source& source, std::int32_t offset) -> bool
+        {
+            return (Patterns::match(source, offset) || ...);
+        }
+    };
+
+    template<lib::keyword Keyword> using ident = token<lexeme_type::identifier, Keyword>;
+    template<lib::keyword Keyword> using directive = token<lexeme_type::directive, Keyword>;
+
+    // MARK: - Common Tokens
+
+    using identifier = token<lexeme_type::identifier>;
+    using string = token<lexeme_type::string>;
+    using integer = token<lexeme_type::integer>;
+    using percentage = token<lexeme_type::percentage>;
+    using hex = token<lexeme_type::hex>;
+    using color = token<lexeme_type::color>;
+    using resource_ref = token<lexeme_type::resource_ref>;
+    using var = token<lexeme_type::var>;
+    using equals = token<lexeme_type::equals>;
+    using semicolon = token<lexeme_type::semicolon>;
+    using comma = token<lexeme_type::comma>;
+    using colon = token<lexeme_type::colon>;
+    using scope = token<lexeme_type::scope>;
+    using dot = token<lexeme_type::dot>;
+    using lbrace = token<lexeme_type::lbrace>;
+    using rbrace = token<lexeme_type::rbrace>;
+    using lparen = token<lexeme_type::lparen>;
+    using rparen = token<lexeme_type::rparen>;
+    using lbracket = token<lexeme_type::lbracket>;
+    using rbracket = token<lexeme_type::rbracket>;
+    using langle = token<lexeme_type::langle>;
+    using rangle = token<lexeme_type::rangle>;
+}
+
+#endif //KDL_PARSER_CONSUMER_PATTERN_HPP
@@ -21,6 +21,7 @@
 #include <utility>
 #include <kdl/parser/parser.hpp>
 #include <kdl/lexer/lexer.hpp>
+#include <kdl/lexer/source_registry.hpp>
 #include <kdl/parser/sema/directive/out.hpp>
 #include <kdl/parser/sema/module/module.hpp>
 #include <kdl/parser/sema/directive/import.hpp>
@@ -29,46 +30,79 @@
 
 namespace kdl::lib::spec::keyword
 {
-    constexpr const char *project { "project" };
-    constexpr const char *module { "module" };
-    constexpr const char *out { "out" };
-    constexpr const char *import { "import" };
+    constexpr lib::keyword project { lib::keyword::project };
+    constexpr lib::keyword module { lib::keyword::module };
+    constexpr lib::keyword out { lib::keyword::out };
+    constexpr lib::keyword import { lib::keyword::import };
 };
 
 // MARK: - Top Level Parser
 
 auto kdl::lib::parser::parse(const std::shared_ptr<source_file> &source) -> void
 {
-    parse(lexer(source).scan());
+    // The source is recorded in to a compact token tape, and lexemes are only constructed as the parser reads them.
+    // Any files that it imports start loading in the background straight away.
+    auto tape = std::make_shared<token_tape>(lexer(source).scan_tape());
+    source_registry::shared().prefetch_imports(*tape);
+    parse(std::move(tape));
+}
+
+auto kdl::lib::parser::parse(std::string_view borrowed_source) -> void
+{
+    // The text is borrowed rather than copied, so it must outlive the result of the parse.
+    parse(std::make_shared<source_file>(borrowed_source.data(), borrowed_source.size()));
+}
+
+auto kdl::lib::parser::parse(std::shared_ptr<const token_tape> tape) -> void
+{
+    // The consumer is reset rather than replaced, so that the storage it allocated for a previous parse is reused.
+    m_consumer.reset(std::move(tape));
+    parse_statements();
 }
 
 auto kdl::lib::parser::parse(std::vector<lexeme> lexemes) -> void
 {
-    m_global_namespace = std::make_shared<name_space>();
     m_consumer = lexeme_consumer(std::move(lexemes));
+    parse_statements();
+}
+
+auto kdl::lib::parser::parse_statements() -> void
+{
+    // Each parse tracks the files it has imported separately.
+    source_registry::shared().reset_includes();
+
+    m_global_namespace = std::make_shared<name_space>();
+    m_modules.clear();
 
     while (!m_consumer.finished()) {
 
-        if (m_consumer.expect_any({
-            expect(lexeme_type::directive, spec::keyword::project).t(),
-            expect(lexeme_type::directive, spec::keyword::module).t()
-        })) {
+        if (m_consumer.expect<pattern::any<
+            pattern::directive<spec::keyword::project>,
+            pattern::directive<spec::keyword::module>
+        >>()) {
             sema::module::parse(m_consumer, m_global_namespace, m_modules);
         }
-        else if (m_consumer.expect( expect(lexeme_type::directive, spec::keyword::out).t() )) {
+        else if (m_consumer.expect<pattern::directive<spec::keyword::out>>()) {
             sema::directive::out::parse(m_consumer);
         }
-        else if (m_consumer.expect( expect(lexeme_type::directive, spec::keyword::import).t() )) {
+        else if (m_consumer.expect<pattern::directive<spec::keyword::import>>()) {
             sema::directive::import::parse(m_consumer);
         }
         else {
             report::error(m_consumer.peek(), "Unexpected lexeme encountered.");
         }
 
-        m_consumer.assert_lexemes({ expect(lexeme_type::semicolon).t() });
+        m_consumer.assert_lexemes<pattern::semicolon>();
+        m_consumer.discard_consumed();
     }
 }
 
+auto kdl::lib::parser::release() -> void
+{
+    // Let go of the tape from the last parse (so that its owner can reuse it), without giving up any storage.
+    m_consumer.reset(nullptr);
+}
+
 // MARK: - Accessor
 
 auto kdl::lib::parser::result() const -> parse_result
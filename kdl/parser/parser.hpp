@@ -23,8 +23,10 @@
 
 #include <vector>
 #include <memory>
+#include <string_view>
 #include <kdl/file/source_file.hpp>
 #include <kdl/lexer/lexeme.hpp>
+#include <kdl/lexer/token_tape.hpp>
 #include <kdl/parser/consumer/consumer.hpp>
 #include <kdl/parser/result.hpp>
 
@@ -36,15 +38,20 @@ namespace kdl::lib
     class parser
     {
     private:
-        lexeme_consumer m_consumer { {} };
+        lexeme_consumer m_consumer { std::vector<lexeme>() };
         std::shared_ptr<name_space> m_global_namespace;
         std::vector<std::shared_ptr<module>> m_modules;
 
+        auto parse_statements() -> void;
+
     public:
         parser() = default;
 
         auto parse(const std::shared_ptr<source_file>& source) -> void;
+        auto parse(std::string_view borrowed_source) -> void;
+        auto parse(std::shared_ptr<const token_tape> tape) -> void;
         auto parse(std::vector<lexeme> lexemes) -> void;
+        auto release() -> void;
 
         [[nodiscard]] auto result() const -> parse_result;
     };
@@ -25,23 +25,21 @@
 
 namespace kdl::lib::spec::keywords
 {
-    constexpr const char *declare { "declare" };
-    constexpr const char *new_ { "new" };
-    constexpr const char *override { "override" };
-    constexpr const char *duplicate { "duplicate" };
-    constexpr const char *import { "import" };
+    constexpr lib::keyword declare { lib::keyword::declare };
+    constexpr lib::keyword new_ { lib::keyword::new_ };
+    constexpr lib::keyword override { lib::keyword::override };
+    constexpr lib::keyword duplicate { lib::keyword::duplicate };
+    constexpr lib::keyword import { lib::keyword::import };
 }
 
 auto kdl::lib::sema::declare::parse(kdl::lib::lexeme_consumer &consumer, const std::shared_ptr<kdl::lib::module> &module) -> void
 {
-    consumer.assert_lexemes({
-        expect(lexeme_type::identifier, spec::keywords::declare).t()
-    });
+    consumer.assert_lexemes<pattern::ident<spec::keywords::declare>>();
 
-    if (!consumer.expect( expect(lexeme_type::identifier).t() )) {
+    if (!consumer.expect<pattern::identifier>()) {
         report::error(consumer.peek(), "Declaration requires an identifier for the resource type name.");
     }
-    auto type_name = consumer.read();
+    const auto& type_name = consumer.read();
 
     // Look up the resource type and validate it.
     auto type = module->resource_type_named(type_name.string_value()).lock();
@@ -49,31 +47,27 @@ auto kdl::lib::sema::declare::parse(kdl::lib::lexeme_consumer &consumer, const s
         report::error(type_name, "Resource type '" + type_name.string_value() + "' is not recognised.");
     }
 
-    consumer.assert_lexemes({
-        expect(lexeme_type::lbrace).t()
-    });
+    consumer.assert_lexemes<pattern::lbrace>();
 
-    while (consumer.expect( expect(lexeme_type::rbrace).f() )) {
-        if (consumer.expect({ expect(lexeme_type::identifier, spec::keywords::new_).t() })) {
+    while (consumer.expect<pattern::not_<pattern::rbrace>>()) {
+        if (consumer.expect<pattern::ident<spec::keywords::new_>>()) {
             sema::declare::new_resource::parse(consumer, module, type);
         }
-        else if (consumer.expect({ expect(lexeme_type::identifier, spec::keywords::override).t() })) {
+        else if (consumer.expect<pattern::ident<spec::keywords::override>>()) {
 
         }
-        else if (consumer.expect({ expect(lexeme_type::identifier, spec::keywords::duplicate).t() })) {
+        else if (consumer.expect<pattern::ident<spec::keywords::duplicate>>()) {
 
         }
-        else if (consumer.expect({ expect(lexeme_type::identifier, spec::keywords::import).t() })) {
+        else if (consumer.expect<pattern::ident<spec::keywords::import>>()) {
 
         }
         else {
             report::error(consumer.peek(), "Unrecognised token encountered in resource declaration.");
         }
 
-        consumer.assert_lexemes({ expect(lexeme_type::semicolon).t() });
+        consumer.assert_lexemes<pattern::semicolon>();
     }
 
-    consumer.assert_lexemes({
-        expect(lexeme_type::rbrace).t()
-    });
+    consumer.assert_lexemes<pattern::rbrace>();
 }
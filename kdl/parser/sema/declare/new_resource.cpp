@@ -25,42 +25,43 @@
 #include <kdl/schema/resource/resource.hpp>
 #include <kdl/schema/resource_type/resource_type.hpp>
 #include <kdl/report/reporting.hpp>
+#include <kdl/lexer/source_registry.hpp>
 #include <kdl/schema/resource_type/resource_field.hpp>
 #include <iostream>
 
 namespace kdl::lib::spec::keywords
 {
-    constexpr const char *new_ { "new" };
+    constexpr lib::keyword new_ { lib::keyword::new_ };
 }
 
 auto kdl::lib::sema::declare::new_resource::parse(kdl::lib::lexeme_consumer &consumer,
                                                   const std::shared_ptr<kdl::lib::module> &module,
                                                   const std::shared_ptr<kdl::lib::resource_type> &type) -> void
 {
-    consumer.assert_lexemes({
-        expect(lexeme_type::identifier, spec::keywords::new_).t(),
-        expect(lexeme_type::lparen).t()
-    });
+    consumer.assert_lexemes<pattern::seq<
+        pattern::ident<spec::keywords::new_>,
+        pattern::lparen
+    >>();
 
     int64_t id = INT64_MIN;
     std::string name = "";
 
-    while (consumer.expect( expect(lexeme_type::rparen).f() )) {
-        if (consumer.expect( expect(lexeme_type::resource_ref).t() )) {
+    while (consumer.expect<pattern::not_<pattern::rparen>>()) {
+        if (consumer.expect<pattern::resource_ref>()) {
             id = consumer.read().int64_value();
         }
-        else if (consumer.expect( expect(lexeme_type::string).t() )) {
+        else if (consumer.expect<pattern::string>()) {
             name = consumer.read().string_value();
         }
         else {
             report::error(consumer.peek(), "Expected either a resource id, or a name.");
         }
 
-        if (consumer.expect( expect(lexeme_type::comma).t() )) {
+        if (consumer.expect<pattern::comma>()) {
             consumer.advance();
             continue;
         }
-        else if (consumer.expect( expect(lexeme_type::rparen).t() )) {
+        else if (consumer.expect<pattern::rparen>()) {
             consumer.advance();
             break;
         }
@@ -75,19 +76,23 @@ auto kdl::lib::sema::declare::new_resource::parse(kdl::lib::lexeme_consumer &con
     // is, then completely disregard the parsing of this resource.
     // Only single field resources can be created this way.
 
-    if (consumer.expect_all({
-        expect(lexeme_type::equals).t(), expect(lexeme_type::identifier, "file").t(),
-        expect(lexeme_type::string).t()
-    })) {
+    if (consumer.expect<pattern::seq<
+        pattern::equals,
+        pattern::ident<keyword::file>,
+        pattern::string
+    >>()) {
         if (type->fields().size() == 1) {
             consumer.advance(2);
-            auto path = consumer.read();
+            const auto& path = consumer.read();
 
             // To resolve the path, we need to get the file that the path is contained with in, as it is
             // relative to it.
             auto absolute_path = path.file_reference().file().relative_path(path.string_value());
-            auto file = source_file("", absolute_path);
-            auto file_contents = lexeme(lexeme_type::string, file.source());
+            // The contents of the file are not copied, but referenced directly from the loaded source file. Files that
+            // are referenced by more than one resource are only loaded once.
+            auto file = source_registry::shared().load(absolute_path);
+            auto size = file->size();
+            auto file_contents = lexeme(lexeme_type::string, { file, 0, size }, 0, size);
             auto field = type->fields().front();
 
             resource->set_value(file_contents, field->name());
@@ -100,19 +105,17 @@ auto kdl::lib::sema::declare::new_resource::parse(kdl::lib::lexeme_consumer &con
         }
     }
 
-    consumer.assert_lexemes({
-        expect(lexeme_type::lbrace).t()
-    });
+    consumer.assert_lexemes<pattern::lbrace>();
 
-    while (consumer.expect( expect(lexeme_type::rbrace).f() )) {
-        if (!consumer.expect_all({
-            expect(lexeme_type::identifier).t(),
-            expect(lexeme_type::equals).t()
-        })) {
+    while (consumer.expect<pattern::not_<pattern::rbrace>>()) {
+        if (!consumer.expect<pattern::seq<
+            pattern::identifier,
+            pattern::equals
+        >>()) {
             report::error(consumer.peek(), "Expected identifier for field name.");
         }
 
-        auto field_name = consumer.read();
+        const auto& field_name = consumer.read();
         consumer.advance();
 
         auto field = type->field_named(field_name.string_value());
@@ -122,14 +125,10 @@ auto kdl::lib::sema::declare::new_resource::parse(kdl::lib::lexeme_consumer &con
 
         sema::declare::resource::values::parse(consumer, resource, field);
 
-        consumer.assert_lexemes({
-            expect(lexeme_type::semicolon).t()
-        });
+        consumer.assert_lexemes<pattern::semicolon>();
     }
 
-    consumer.assert_lexemes({
-        expect(lexeme_type::rbrace).t()
-    });
+    consumer.assert_lexemes<pattern::rbrace>();
 
     module->add_resource(resource);
 }
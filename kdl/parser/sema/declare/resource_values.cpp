@@ -33,7 +33,7 @@ auto kdl::lib::sema::declare::resource::values::parse(lexeme_consumer &consumer,
     for (const auto& expected_value : field->values()) {
         // First of all we need to determine if their is even a value? If there isn't then we _must_
         // have default values available for the expected value.
-        if (consumer.expect( expect(lexeme_type::semicolon).t() )) {
+        if (consumer.expect<pattern::semicolon>()) {
             // We _require_ a default value here...
             if (!expected_value->default_value().has_value()) {
                 report::error(consumer.peek(), "Unexpected end of field. Missing value for '" + expected_value->name() + "'");
@@ -50,26 +50,27 @@ auto kdl::lib::sema::declare::resource::values::parse(lexeme_consumer &consumer,
 
         switch (expected_value->expected_value_lexeme_type()) {
             case kdl::lib::lexeme_type::integer: {
-                if (!consumer.expect_any({
-                    expect(lexeme_type::integer).t(), expect(lexeme_type::hex).t(),
-                    expect(lexeme_type::percentage).t(), expect(lexeme_type::resource_ref).t()
-                })) {
+                if (!consumer.expect<pattern::any<
+                    pattern::integer,
+                    pattern::hex,
+                    pattern::percentage,
+                    pattern::resource_ref
+                >>()) {
                     report::error(consumer.peek(), "Expected an integer value.");
                 }
                 break;
             }
             case kdl::lib::lexeme_type::color: {
-                if (!consumer.expect_any({
-                    expect(lexeme_type::color).t(), expect(lexeme_type::hex).t()
-                })) {
+                if (!consumer.expect<pattern::any<
+                    pattern::color,
+                    pattern::hex
+                >>()) {
                     report::error(consumer.peek(), "Expected a color representation, via an integer value.");
                 }
                 break;
             }
             case kdl::lib::lexeme_type::string: {
-                if (!consumer.expect_any({
-                    expect(lexeme_type::string).t()
-                })) {
+                if (!consumer.expect<pattern::string>()) {
                     report::error(consumer.peek(), "Expected a string value.");
                 }
                 break;
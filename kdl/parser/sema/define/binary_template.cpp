@@ -27,55 +27,55 @@ auto kdl::lib::sema::define::binary_template::parse(lexeme_consumer& consumer,
                                                     const std::shared_ptr<struct binary_template>& tmpl,
                                                     const std::shared_ptr<module>& module) -> void
 {
-    while (consumer.expect( expect(lexeme_type::rbrace).f() )) {
+    while (consumer.expect<pattern::not_<pattern::rbrace>>()) {
         std::vector<std::string> namespace_path;
 
-        while (consumer.expect_all({
-            expect(lexeme_type::identifier).t(),
-            expect(lexeme_type::scope).t()
-        })) {
+        while (consumer.expect<pattern::seq<
+            pattern::identifier,
+            pattern::scope
+        >>()) {
             namespace_path.emplace_back(consumer.read().string_value());
             consumer.advance(1);
         }
 
-        if (!consumer.expect( expect(lexeme_type::identifier).t() )) {
+        if (!consumer.expect<pattern::identifier>()) {
             report::error(consumer.peek(), "Expected identifier for binary field type.");
         }
-        auto binary_type_name = consumer.read();
+        const auto& binary_type_name = consumer.read();
         auto binary_type = module->binary_type_named(binary_type_name.string_value(), namespace_path);
         if (binary_type.expired()) {
             report::error(binary_type_name, "Unknown binary type specified: '" + binary_type_name.string_value() + "'");
         }
 
         std::unordered_map<std::string, lexeme> args;
-        if (consumer.expect( expect(lexeme_type::langle).t() )) {
+        if (consumer.expect<pattern::langle>()) {
             consumer.advance();
 
             // Make sure we have the correct number of attachments provided.
             const auto& attachments = binary_type.lock()->attachments();
             for (const auto& it : attachments) {
-                if (!consumer.expect_any({
-                    expect(lexeme_type::integer).t(),
-                    expect(lexeme_type::percentage).t(),
-                    expect(lexeme_type::resource_ref).t()
-                })) {
+                if (!consumer.expect<pattern::any<
+                    pattern::integer,
+                    pattern::percentage,
+                    pattern::resource_ref
+                >>()) {
                     report::error(consumer.peek(), "Expected numeric value for binary field type argument.");
                 }
 
-                auto arg = consumer.read();
+                const auto& arg = consumer.read();
                 args.insert(std::pair(it.string_value(), arg));
             }
 
-            consumer.assert_lexemes({ expect(lexeme_type::rangle).t() });
+            consumer.assert_lexemes<pattern::rangle>();
         }
 
-        if (!consumer.expect_all({ expect(lexeme_type::identifier).t() })) {
+        if (!consumer.expect<pattern::identifier>()) {
             report::error(consumer.peek(), "Expected identifier for field name.");
         }
 
-        auto field_name = consumer.read();
+        const auto& field_name = consumer.read();
         tmpl->add_field(binary_type.lock(), args, field_name.string_value());
 
-        consumer.assert_lexemes({ expect(lexeme_type::semicolon).t() });
+        consumer.assert_lexemes<pattern::semicolon>();
     }
 }
@@ -25,116 +25,116 @@
 
 namespace kdl::lib::spec::keyword
 {
-    constexpr const char *isa { "isa" };
-    constexpr const char *integer { "integer" };
-    constexpr const char *string { "string" };
-    constexpr const char *color { "color" };
-    constexpr const char *size { "size" };
-    constexpr const char *null_terminated { "null_terminated" };
-    constexpr const char *counted { "counted" };
-    constexpr const char *fixed { "fixed" };
-    constexpr const char *chr { "char" };
-    constexpr const char *is_signed { "is_signed" };
+    constexpr lib::keyword isa { lib::keyword::isa };
+    constexpr lib::keyword integer { lib::keyword::integer };
+    constexpr lib::keyword string { lib::keyword::string };
+    constexpr lib::keyword color { lib::keyword::color };
+    constexpr lib::keyword size { lib::keyword::size };
+    constexpr lib::keyword null_terminated { lib::keyword::null_terminated };
+    constexpr lib::keyword counted { lib::keyword::counted };
+    constexpr lib::keyword fixed { lib::keyword::fixed };
+    constexpr lib::keyword chr { lib::keyword::chr };
+    constexpr lib::keyword is_signed { lib::keyword::is_signed };
 }
 
 namespace kdl::lib::sema::define::binary_type::encoding
 {
-    constexpr const char *ascii { "ascii" };
-    constexpr const char *macroman { "macroman" };
-    constexpr const char *utf8 { "utf8" };
+    constexpr lib::keyword ascii { lib::keyword::ascii };
+    constexpr lib::keyword macroman { lib::keyword::macroman };
+    constexpr lib::keyword utf8 { lib::keyword::utf8 };
 }
 
 auto kdl::lib::sema::define::binary_type::parse(lexeme_consumer &consumer, const std::shared_ptr<struct binary_type>& type) -> void
 {
-    auto name = consumer.peek(-1);
-    while (consumer.expect( expect(lexeme_type::rbrace).f() )) {
+    const auto& name = consumer.peek(-1);
+    while (consumer.expect<pattern::not_<pattern::rbrace>>()) {
 
-        if (consumer.expect_all({
-            expect(lexeme_type::identifier, spec::keyword::isa).t(),
-            expect(lexeme_type::equals).t(),
-            expect(lexeme_type::identifier).t()
-        })) {
+        if (consumer.expect<pattern::seq<
+            pattern::ident<spec::keyword::isa>,
+            pattern::equals,
+            pattern::identifier
+        >>()) {
             consumer.advance(2);
-            auto isa_type = consumer.read();
-            if (isa_type.string_value() == spec::keyword::integer) {
+            const auto& isa_type = consumer.read();
+            if (isa_type.is(spec::keyword::integer)) {
                 type->set_isa(binary_type_isa::integer);
             }
-            else if (isa_type.string_value() == spec::keyword::string) {
+            else if (isa_type.is(spec::keyword::string)) {
                 type->set_isa(binary_type_isa::string);
             }
-            else if (isa_type.string_value() == spec::keyword::color) {
+            else if (isa_type.is(spec::keyword::color)) {
                 type->set_isa(binary_type_isa::color);
             }
             else {
                 report::error(isa_type, "Unrecognised binary type isa '" + isa_type.string_value() + "'");
             }
         }
-        else if (consumer.expect_all({
-            expect(lexeme_type::identifier, spec::keyword::size).t(),
-            expect(lexeme_type::equals).t(),
-            expect(lexeme_type::integer).t()
-        })) {
+        else if (consumer.expect<pattern::seq<
+            pattern::ident<spec::keyword::size>,
+            pattern::equals,
+            pattern::integer
+        >>()) {
             consumer.advance(2);
             type->set_size(consumer.read());
         }
-        else if (consumer.expect_all({
-            expect(lexeme_type::identifier, spec::keyword::size).t(),
-            expect(lexeme_type::equals).t(),
-            expect(lexeme_type::identifier, spec::keyword::null_terminated).t(),
-            expect(lexeme_type::integer).t(),
-        })) {
+        else if (consumer.expect<pattern::seq<
+            pattern::ident<spec::keyword::size>,
+            pattern::equals,
+            pattern::ident<spec::keyword::null_terminated>,
+            pattern::integer
+        >>()) {
             consumer.advance(3);
             type->set_size(consumer.read(), kdl::lib::binary_type::size_type::null_terminated);
         }
-        else if (consumer.expect_all({
-            expect(lexeme_type::identifier, spec::keyword::size).t(),
-            expect(lexeme_type::equals).t(),
-            expect(lexeme_type::identifier, spec::keyword::null_terminated).t(),
-            expect(lexeme_type::var).t(),
-        })) {
+        else if (consumer.expect<pattern::seq<
+            pattern::ident<spec::keyword::size>,
+            pattern::equals,
+            pattern::ident<spec::keyword::null_terminated>,
+            pattern::var
+        >>()) {
             consumer.advance(3);
             type->set_size(consumer.read(), kdl::lib::binary_type::size_type::null_terminated);
         }
-        else if (consumer.expect_all({
-            expect(lexeme_type::identifier, spec::keyword::size).t(),
-            expect(lexeme_type::equals).t(),
-            expect(lexeme_type::identifier, spec::keyword::null_terminated).t()
-        })) {
+        else if (consumer.expect<pattern::seq<
+            pattern::ident<spec::keyword::size>,
+            pattern::equals,
+            pattern::ident<spec::keyword::null_terminated>
+        >>()) {
             consumer.advance(3);
             type->set_size(lexeme(lexeme_type::integer, "0"), kdl::lib::binary_type::size_type::null_terminated);
         }
-        else if (consumer.expect_all({
-            expect(lexeme_type::identifier, spec::keyword::size).t(),
-            expect(lexeme_type::equals).t(),
-            expect(lexeme_type::identifier, spec::keyword::counted).t(),
-            expect(lexeme_type::integer).t()
-        })) {
+        else if (consumer.expect<pattern::seq<
+            pattern::ident<spec::keyword::size>,
+            pattern::equals,
+            pattern::ident<spec::keyword::counted>,
+            pattern::integer
+        >>()) {
             consumer.advance(3);
             type->set_size(consumer.read(), kdl::lib::binary_type::size_type::count);
         }
-        else if (consumer.expect_all({
-            expect(lexeme_type::identifier, spec::keyword::size).t(),
-            expect(lexeme_type::equals).t(),
-            expect(lexeme_type::identifier, spec::keyword::fixed).t(),
-            expect(lexeme_type::integer).t()
-        })) {
+        else if (consumer.expect<pattern::seq<
+            pattern::ident<spec::keyword::size>,
+            pattern::equals,
+            pattern::ident<spec::keyword::fixed>,
+            pattern::integer
+        >>()) {
             consumer.advance(3);
             type->set_size(consumer.read(), kdl::lib::binary_type::size_type::fixed);
         }
-        else if (consumer.expect_all({
-            expect(lexeme_type::identifier, spec::keyword::chr).t(),
-            expect(lexeme_type::equals).t(),
-            expect(lexeme_type::identifier).t()
-        })) {
+        else if (consumer.expect<pattern::seq<
+            pattern::ident<spec::keyword::chr>,
+            pattern::equals,
+            pattern::identifier
+        >>()) {
             consumer.advance(2);
-            auto enc_type = consumer.read();
-            if (enc_type.string_value() == encoding::ascii) {
+            const auto& enc_type = consumer.read();
+            if (enc_type.is(encoding::ascii)) {
                 type->set_char_encoding(binary_type_char_encoding::ascii);
             }
-            else if (enc_type.string_value() == encoding::macroman) {
+            else if (enc_type.is(encoding::macroman)) {
                 type->set_char_encoding(binary_type_char_encoding::macroman);
             }
-            else if (enc_type.string_value() == encoding::utf8) {
+            else if (enc_type.is(encoding::utf8)) {
                 type->set_char_encoding(binary_type_char_encoding::utf8);
             }
             else {
@@ -142,12 +142,12 @@ auto kdl::lib::sema::define::binary_type::parse(lexeme_consumer &consumer, const
                 type->set_char_encoding(binary_type_char_encoding::macroman);
             }
         }
-        else if (consumer.expect( expect(lexeme_type::identifier, spec::keyword::is_signed).t() )) {
+        else if (consumer.expect<pattern::ident<spec::keyword::is_signed>>()) {
             consumer.advance();
             type->set_signed(true);
         }
 
-        consumer.assert_lexemes({ expect(lexeme_type::semicolon).t() });
+        consumer.assert_lexemes<pattern::semicolon>();
     }
 
     if (type->isa() == binary_type_isa::color && type->size() != 32) {
@@ -33,43 +33,43 @@
 
 namespace kdl::lib::spec::keywords
 {
-    constexpr const char *define { "define" };
-    constexpr const char *type { "type" };
-    constexpr const char *tmpl { "template" };
-    constexpr const char *function { "function" };
+    constexpr lib::keyword define { lib::keyword::define };
+    constexpr lib::keyword type { lib::keyword::type };
+    constexpr lib::keyword tmpl { lib::keyword::tmpl };
+    constexpr lib::keyword function { lib::keyword::function };
 }
 
 auto kdl::lib::sema::define::parse(lexeme_consumer &consumer, const std::shared_ptr<module> &module) -> void
 {
-    consumer.assert_lexemes({
-        expect(lexeme_type::identifier, spec::keywords::define).t(),
-        expect(lexeme_type::lparen).t()
-    });
+    consumer.assert_lexemes<pattern::seq<
+        pattern::ident<spec::keywords::define>,
+        pattern::lparen
+    >>();
 
     std::function<auto()->void> continuation = [] {};
 
-    if (consumer.expect( expect(lexeme_type::star).t() )) {
+    if (consumer.expect<pattern::token<lexeme_type::star>>()) {
         consumer.advance();
 
-        if (consumer.expect_all({
-            expect(lexeme_type::identifier, spec::keywords::type).t(),
-            expect(lexeme_type::identifier).t()
-        })) {
+        if (consumer.expect<pattern::seq<
+            pattern::ident<spec::keywords::type>,
+            pattern::identifier
+        >>()) {
             // Binary Type Definition
             consumer.advance();
-            auto name = consumer.read();
+            const auto& name = consumer.read();
 
             // Check for any attachment values.
             std::vector<lexeme> attachments;
-            if (consumer.expect( expect(lexeme_type::langle).t() )) {
+            if (consumer.expect<pattern::langle>()) {
                 consumer.advance();
-                while (consumer.expect( expect(lexeme_type::rangle).f() )) {
+                while (consumer.expect<pattern::not_<pattern::rangle>>()) {
                     attachments.emplace_back(consumer.read());
 
-                    if (consumer.expect( expect(lexeme_type::rangle).t() )) {
+                    if (consumer.expect<pattern::rangle>()) {
                         break;
                     }
-                    else if (consumer.expect( expect(lexeme_type::comma).t() )) {
+                    else if (consumer.expect<pattern::comma>()) {
                         consumer.advance();
                         continue;
                     }
@@ -77,7 +77,7 @@ auto kdl::lib::sema::define::parse(lexeme_consumer &consumer, const std::shared_
                         report::error(consumer.peek(), "Expected either '<' or ','");
                     }
                 }
-                consumer.assert_lexemes({ expect(lexeme_type::rangle).t() });
+                consumer.assert_lexemes<pattern::rangle>();
             }
 
             continuation = [&consumer, name, module, attachments] {
@@ -87,55 +87,50 @@ auto kdl::lib::sema::define::parse(lexeme_consumer &consumer, const std::shared_
                 module->add_binary_type_definition(type);
             };
         }
-        else if (consumer.expect_all({
-            expect(lexeme_type::identifier, spec::keywords::tmpl).t(),
-            expect(lexeme_type::identifier).t()
-        })) {
+        else if (consumer.expect<pattern::seq<
+            pattern::ident<spec::keywords::tmpl>,
+            pattern::identifier
+        >>()) {
             // Binary Template Definition
             consumer.advance();
-            auto name = consumer.read();
+            const auto& name = consumer.read();
             continuation = [&consumer, name, module] {
                 auto tmpl = std::make_shared<struct binary_template>(name.string_value());
                 sema::define::binary_template::parse(consumer, tmpl, module);
                 module->add_binary_template_definition(tmpl);
             };
         }
-        else if (consumer.expect_all({
-            expect(lexeme_type::identifier, spec::keywords::function).t(),
-            expect(lexeme_type::colon).t(),
-        })) {
+        else if (consumer.expect<pattern::seq<
+            pattern::ident<spec::keywords::function>,
+            pattern::colon
+        >>()) {
             consumer.advance(2);
             auto function = sema::define::function::parse(consumer, module);
             module->add_function(function);
 
             continuation = [&consumer, function, module] {
-                auto brace_balancer = 0;
-                std::vector<lexeme> fn_body;
-                while (consumer.expect( expect(lexeme_type::rbrace).f()) || brace_balancer > 0) {
-                    if (consumer.expect( expect(lexeme_type::lbrace).t() )) {
-                        brace_balancer++;
-                    }
-                    else if (consumer.expect( expect(lexeme_type::rbrace).t() )) {
-                        brace_balancer--;
-                    }
-                    fn_body.emplace_back(consumer.read());
+                // The body runs up to the brace that closes the one opening it, which has just been consumed.
+                auto end = consumer.matching_delimiter(-1);
+                if (!end.has_value()) {
+                    report::error(consumer.peek(-1), "Function body is not closed.");
                 }
-                function->set_body(fn_body);
+                function->set_body(consumer.slice(0, static_cast<std::size_t>(*end)));
+                consumer.advance(*end);
             };
         }
         else {
             report::error(consumer.peek(), "Unexpected definition type provided.");
         }
     }
-    else if (consumer.expect_all({
-        expect(lexeme_type::identifier).t(),
-        expect(lexeme_type::colon).t(),
-        expect(lexeme_type::string).t()
-    })) {
+    else if (consumer.expect<pattern::seq<
+        pattern::identifier,
+        pattern::colon,
+        pattern::string
+    >>()) {
         // Resource Type Definition
-        auto name = consumer.read();
+        const auto& name = consumer.read();
         consumer.advance();
-        auto code = consumer.read();
+        const auto& code = consumer.read();
         continuation = [&consumer, name, code, module] {
             auto type = std::make_shared<struct resource_type>(name.string_value(), code.string_value());
             sema::define::resource_type::parse(consumer, type, module);
@@ -146,14 +141,12 @@ auto kdl::lib::sema::define::parse(lexeme_consumer &consumer, const std::shared_
         report::error(consumer.peek(), "Unexpected token in definition found.");
     }
 
-    consumer.assert_lexemes({
-        expect(lexeme_type::rparen).t(),
-        expect(lexeme_type::lbrace).t()
-    });
+    consumer.assert_lexemes<pattern::seq<
+        pattern::rparen,
+        pattern::lbrace
+    >>();
 
     continuation();
 
-    consumer.assert_lexemes({
-        expect(lexeme_type::rbrace).t(),
-    });
+    consumer.assert_lexemes<pattern::rbrace>();
 }
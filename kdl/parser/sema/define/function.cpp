@@ -30,22 +30,22 @@ auto kdl::lib::sema::define::function::parse(kdl::lib::lexeme_consumer &consumer
 {
     std::vector<std::string> ns;
 
-    while (consumer.expect_all({ expect(lexeme_type::identifier).t(), expect(lexeme_type::scope).t() })) {
+    while (consumer.expect<pattern::seq<pattern::identifier, pattern::scope>>()) {
         ns.emplace_back(consumer.read().string_value());
         consumer.advance();
     }
 
-    if (!consumer.expect_all({
-        expect(lexeme_type::identifier).t(),
-        expect(lexeme_type::dot).t(),
-        expect(lexeme_type::identifier).t()
-    })) {
+    if (!consumer.expect<pattern::seq<
+        pattern::identifier,
+        pattern::dot,
+        pattern::identifier
+    >>()) {
         report::error(consumer.peek(), "Unexpected token sequence for function name.");
     }
 
     // Get the construction type for the function. This tells KDL what type the function is associated with, and
     // what type it is trying to create.
-    auto construction_type_name = consumer.read();
+    const auto& construction_type_name = consumer.read();
     auto construction_type = module->binary_type_named(construction_type_name.string_value(), ns).lock();
     if (!construction_type) {
         report::error(construction_type_name, "Construction type of function is not recognised.");
@@ -56,43 +56,43 @@ auto kdl::lib::sema::define::function::parse(kdl::lib::lexeme_consumer &consumer
     consumer.advance();
 
     // Get the function name.
-    auto name = consumer.read();
+    const auto& name = consumer.read();
     auto fn = std::make_shared<struct function>(name.string_value(), construction_type);
     construction_type->add_function(fn);
 
     // Parse out the arguments for the function, if there are any.
-    if (consumer.expect( expect(lexeme_type::colon).t() )) {
+    if (consumer.expect<pattern::colon>()) {
         consumer.advance();
 
-        while (consumer.expect( expect(lexeme_type::rparen).f() )) {
+        while (consumer.expect<pattern::not_<pattern::rparen>>()) {
             ns.clear();
-            while (consumer.expect_all({ expect(lexeme_type::identifier).t(), expect(lexeme_type::scope).t() })) {
+            while (consumer.expect<pattern::seq<pattern::identifier, pattern::scope>>()) {
                 ns.emplace_back(consumer.read().string_value());
                 consumer.advance();
             }
 
-            if (consumer.expect_all({
-                expect(lexeme_type::identifier).t(),
-                expect(lexeme_type::identifier).t()
-            })) {
-                auto argument_type_name = consumer.read();
+            if (consumer.expect<pattern::seq<
+                pattern::identifier,
+                pattern::identifier
+            >>()) {
+                const auto& argument_type_name = consumer.read();
                 auto argument_type = module->binary_type_named(argument_type_name.string_value(), ns).lock();
                 if (!argument_type) {
                     report::error(argument_type_name, "Unrecognised type for argument.");
                 }
 
-                auto argument_name = consumer.read();
+                const auto& argument_name = consumer.read();
                 fn->add_argument({ argument_type, argument_name.string_value() });
             }
             else {
                 report::error(consumer.peek(), "Unexpected token sequence in function argument list.");
             }
 
-            if (consumer.expect( expect(lexeme_type::comma).t() )) {
+            if (consumer.expect<pattern::comma>()) {
                 consumer.advance();
                 continue;
             }
-            else if (consumer.expect( expect(lexeme_type::rparen).t() )) {
+            else if (consumer.expect<pattern::rparen>()) {
                 break;
             }
             else {
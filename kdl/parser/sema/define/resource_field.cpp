@@ -41,8 +41,8 @@ auto kdl::lib::sema::define::resource_field::parse(kdl::lib::lexeme_consumer &co
         report::error(consumer.peek(-1), "Resource type '" + type->name() + "' does not have a template");
     }
 
-    while (consumer.expect( expect(lexeme_type::rbrace).f() )) {
-        auto binary_field_name = consumer.read();
+    while (consumer.expect<pattern::not_<pattern::rbrace>>()) {
+        const auto& binary_field_name = consumer.read();
 
         auto bin_field = tmpl->field_named(binary_field_name.string_value()).lock();
         if (!bin_field) {
@@ -57,24 +57,24 @@ auto kdl::lib::sema::define::resource_field::parse(kdl::lib::lexeme_consumer &co
         // Check for a potential default value and read it. We'll check the value once we have the symbol list, as
         // we may need to resolve it.
         std::optional<lexeme> default_value = {};
-        if (consumer.expect( expect(lexeme_type::equals).t() )) {
+        if (consumer.expect<pattern::equals>()) {
             consumer.advance();
 
-            if (!consumer.expect_any({
-                expect(lexeme_type::string).t(),
-                expect(lexeme_type::identifier).t(),
-                expect(lexeme_type::integer).t(),
-                expect(lexeme_type::hex).t(),
-                expect(lexeme_type::percentage).t(),
-                expect(lexeme_type::resource_ref).t()
-            })) {
+            if (!consumer.expect<pattern::any<
+                pattern::string,
+                pattern::identifier,
+                pattern::integer,
+                pattern::hex,
+                pattern::percentage,
+                pattern::resource_ref
+            >>()) {
                 report::error(consumer.peek(), "Illegal token provided as default value.");
             }
 
             default_value = consumer.read();
 
             // Check the default value to see if it is a function.
-            if (default_value->is(lexeme_type::identifier) && consumer.expect( expect(lexeme_type::lparen).t() )) {
+            if (default_value->is(lexeme_type::identifier) && consumer.expect<pattern::lparen>()) {
                 auto fn = bin_field->type()->function_named(default_value->string_value()).lock();
                 if (fn) {
                     // We are looking at a function... we now need to parse it as such.
@@ -82,13 +82,13 @@ auto kdl::lib::sema::define::resource_field::parse(kdl::lib::lexeme_consumer &co
 
                     // Extract the arguments of the function.
                     std::vector<lexeme> args;
-                    while (consumer.expect( expect(lexeme_type::rparen).f() )) {
+                    while (consumer.expect<pattern::not_<pattern::rparen>>()) {
                         auto expected_arg = fn->argument_type_at(args.size()).lock();
                         if (!expected_arg) {
                             report::error(default_value.value(), "Argument count mismatch in function call.");
                         }
 
-                        auto arg_value = consumer.read();
+                        const auto& arg_value = consumer.read();
                         args.emplace_back(arg_value);
 
                         switch (arg_value.type()) {
@@ -112,13 +112,13 @@ auto kdl::lib::sema::define::resource_field::parse(kdl::lib::lexeme_consumer &co
                                 report::error(arg_value, "Illegal argument value.");
                         }
 
-                        if (consumer.expect( expect(lexeme_type::rparen).f() )) {
-                            consumer.assert_lexemes({ expect(lexeme_type::comma).t() });
+                        if (consumer.expect<pattern::not_<pattern::rparen>>()) {
+                            consumer.assert_lexemes<pattern::comma>();
                         }
                     }
 
                     // Make sure that the function call is closed off correctly, and get ready to execute...
-                    consumer.assert_lexemes({ expect(lexeme_type::rparen).t() });
+                    consumer.assert_lexemes<pattern::rparen>();
 
                     // Pass the function and the arguments to be executed, and then replace default_value with the
                     // result.
@@ -128,10 +128,10 @@ auto kdl::lib::sema::define::resource_field::parse(kdl::lib::lexeme_consumer &co
         }
 
         // Check if the field value has any pre-defined constants/values/symbols.
-        if (consumer.expect( expect(lexeme_type::lbracket).t() )) {
+        if (consumer.expect<pattern::lbracket>()) {
             consumer.advance();
             sema::define::symbol_list::parse(consumer, field_value, field_value->expected_value_lexeme_type());
-            consumer.assert_lexemes({ expect(lexeme_type::rbracket).t() });
+            consumer.assert_lexemes<pattern::rbracket>();
         }
 
         // Now resolve the default value if it exists.
@@ -176,6 +176,6 @@ auto kdl::lib::sema::define::resource_field::parse(kdl::lib::lexeme_consumer &co
             field_value->set_default_value(default_value.value());
         }
 
-        consumer.assert_lexemes({ expect(lexeme_type::semicolon).t() });
+        consumer.assert_lexemes<pattern::semicolon>();
     }
 }
@@ -32,12 +32,12 @@ auto kdl::lib::sema::define::resource_type::parse(kdl::lib::lexeme_consumer &con
                                                   const std::shared_ptr<struct resource_type> &type,
                                                   const std::shared_ptr<module> &module) -> void
 {
-    while (consumer.expect( expect(lexeme_type::rbrace).f() )) {
+    while (consumer.expect<pattern::not_<pattern::rbrace>>()) {
 
-        if (consumer.expect_all({
-            expect(lexeme_type::identifier, "template").t(),
-            expect(lexeme_type::lbrace).t()
-        })) {
+        if (consumer.expect<pattern::seq<
+            pattern::ident<keyword::tmpl>,
+            pattern::lbrace
+        >>()) {
             // In-place template definition
             consumer.advance(2);
 
@@ -47,28 +47,28 @@ auto kdl::lib::sema::define::resource_type::parse(kdl::lib::lexeme_consumer &con
             module->add_binary_template_definition(tmpl);
             type->set_binary_template(tmpl);
 
-            consumer.assert_lexemes({ expect(lexeme_type::rbrace).t() });
+            consumer.assert_lexemes<pattern::rbrace>();
         }
-        else if (consumer.expect_all({
-            expect(lexeme_type::identifier, "template").t(),
-            expect(lexeme_type::equals).t()
-        })) {
+        else if (consumer.expect<pattern::seq<
+            pattern::ident<keyword::tmpl>,
+            pattern::equals
+        >>()) {
             // Existing named template definition
             consumer.advance(2);
 
             std::vector<std::string> namespace_path;
-            while (consumer.expect_all({
-                expect(lexeme_type::identifier).t(),
-                expect(lexeme_type::scope).t()
-            })) {
+            while (consumer.expect<pattern::seq<
+                pattern::identifier,
+                pattern::scope
+            >>()) {
                 namespace_path.emplace_back(consumer.read().string_value());
                 consumer.advance(1);
             }
 
-            if (consumer.expect( expect(lexeme_type::identifier).f() )) {
+            if (consumer.expect<pattern::not_<pattern::identifier>>()) {
                 report::warn(consumer.peek(), "Template name should be an identifier.");
             }
-            auto name = consumer.read();
+            const auto& name = consumer.read();
             auto tmpl = module->binary_template_named(name.string_value(), namespace_path);
             if (tmpl.expired()) {
                 report::error(name, "Unknown binary template specified.");
@@ -76,33 +76,31 @@ auto kdl::lib::sema::define::resource_type::parse(kdl::lib::lexeme_consumer &con
 
             type->set_binary_template(tmpl);
         }
-        else if (consumer.expect_all({
-            expect(lexeme_type::identifier, "assert").t(),
-            expect(lexeme_type::lparen).t()
-        })) {
+        else if (consumer.expect<pattern::seq<
+            pattern::ident<keyword::assert_>,
+            pattern::lparen
+        >>()) {
             // Setup an assertion for resources of this type
         }
-        else if (consumer.expect(
-            expect(lexeme_type::directive, "use_code_editor").t()
-        )) {
+        else if (consumer.expect<pattern::directive<keyword::use_code_editor>>()) {
             // NOTE: This is a specific flag for shipyard, to state that the resource should be opened in a
             // code editor.
             type->set_uses_code_editor(true);
             consumer.advance();
         }
-        else if (consumer.expect_all({
-            expect(lexeme_type::identifier, "field").t(),
-            expect(lexeme_type::identifier).t()
-        })) {
+        else if (consumer.expect<pattern::seq<
+            pattern::ident<keyword::field>,
+            pattern::identifier
+        >>()) {
             // Setup a field definition
             consumer.advance(1);
-            auto name = consumer.read();
+            const auto& name = consumer.read();
             auto field = std::make_shared<struct resource_field>(name.string_value());
 
-            if (consumer.expect( expect(lexeme_type::lbrace).t() )) {
-                consumer.assert_lexemes({ expect(lexeme_type::lbrace).t() });
+            if (consumer.expect<pattern::lbrace>()) {
+                consumer.assert_lexemes<pattern::lbrace>();
                 sema::define::resource_field::parse(consumer, type, field);
-                consumer.assert_lexemes({ expect(lexeme_type::rbrace).t() });
+                consumer.assert_lexemes<pattern::rbrace>();
             }
             else {
                 // The field is implicit, as in the name of the field matches the name of the value
@@ -124,6 +122,6 @@ auto kdl::lib::sema::define::resource_type::parse(kdl::lib::lexeme_consumer &con
             type->add_field(field);
         }
 
-        consumer.assert_lexemes({ expect(lexeme_type::semicolon).t() });
+        consumer.assert_lexemes<pattern::semicolon>();
     }
 }
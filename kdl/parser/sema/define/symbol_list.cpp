@@ -30,37 +30,37 @@ auto kdl::lib::sema::define::symbol_list::parse(kdl::lib::lexeme_consumer &consu
                                                 const std::shared_ptr<struct resource_field_value> &value,
                                                 const kdl::lib::lexeme_type &type) -> void
 {
-    while (consumer.expect( expect(lexeme_type::rbracket).f() )) {
+    while (consumer.expect<pattern::not_<pattern::rbracket>>()) {
         // TODO: Restructure this for better performance. The type check should be done externally and then execute
         // loops according to the type.
-        if (!consumer.expect( expect(lexeme_type::identifier).t() )) {
+        if (!consumer.expect<pattern::identifier>()) {
             report::warn(consumer.peek(), "Symbol name should be an identifier, and can have unintended consequences if not.");
         }
-        auto symbol_name = consumer.read();
+        const auto& symbol_name = consumer.read();
 
-        consumer.assert_lexemes({ expect(lexeme_type::equals).t() });
+        consumer.assert_lexemes<pattern::equals>();
 
         switch (type) {
         case lexeme_type::integer: {
-            if (!consumer.expect_any({
-                expect(lexeme_type::integer).t(),
-                expect(lexeme_type::resource_ref).t(),
-                expect(lexeme_type::percentage).t()
-            })) {
+            if (!consumer.expect<pattern::any<
+                pattern::integer,
+                pattern::resource_ref,
+                pattern::percentage
+            >>()) {
                 report::warn(consumer.peek(), "Symbol value should be an integer type.");
             }
-            auto symbol_value = consumer.read();
+            const auto& symbol_value = consumer.read();
             value->add_symbol(std::make_shared<struct resource_field_symbol>(symbol_name.string_value(), symbol_value));
             break;
         }
         case lexeme_type::string: {
-            if (!consumer.expect_any({
-                expect(lexeme_type::string).t(),
-                expect(lexeme_type::identifier).t()
-            })) {
+            if (!consumer.expect<pattern::any<
+                pattern::string,
+                pattern::identifier
+            >>()) {
                 report::warn(consumer.peek(), "Symbol value should be a string type.");
             }
-            auto symbol_value = consumer.read();
+            const auto& symbol_value = consumer.read();
             value->add_symbol(std::make_shared<struct resource_field_symbol>(symbol_name.string_value(), symbol_value));
             break;
         }
@@ -68,11 +68,11 @@ auto kdl::lib::sema::define::symbol_list::parse(kdl::lib::lexeme_consumer &consu
             report::error(consumer.peek(), "Unknown symbol type requested: " + describe_lexeme_type(type));
         }
 
-        if (consumer.expect_all({ expect(lexeme_type::comma).f(), expect(lexeme_type::rbracket).f() }) && !comma_warning) {
+        if (consumer.expect<pattern::seq<pattern::not_<pattern::comma>, pattern::not_<pattern::rbracket>>>() && !comma_warning) {
             report::warn(consumer.peek(-1), "Symbols in value list should be seperated by a comma.");
             comma_warning = true;
         }
-        else if (consumer.expect( expect(lexeme_type::comma).t() )) {
+        else if (consumer.expect<pattern::comma>()) {
             consumer.advance();
         }
     }
@@ -23,9 +23,9 @@
 
 auto kdl::lib::sema::directive::copyright::parse(lexeme_consumer &consumer, const std::shared_ptr<module>& project) -> void
 {
-    consumer.assert_lexemes({ expect(lexeme_type::directive, "copyright").t() });
+    consumer.assert_lexemes<pattern::directive<keyword::copyright>>();
 
-    while (consumer.expect( expect(lexeme_type::semicolon).f() )) {
+    while (consumer.expect<pattern::not_<pattern::semicolon>>()) {
         project->add_copyright(consumer.read().string_value());
     }
 }
\ No newline at end of file
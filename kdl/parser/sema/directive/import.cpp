@@ -19,7 +19,7 @@
 // SOFTWARE.
 
 #include <kdl/parser/sema/directive/import.hpp>
-#include <kdl/lexer/lexer.hpp>
+#include <kdl/lexer/source_registry.hpp>
 #include <kdl/report/reporting.hpp>
 #include <kdl/builtin/resedit_types.hpp>
 #include <kdl/builtin/posix_types.hpp>
@@ -27,25 +27,32 @@
 
 auto kdl::lib::sema::directive::import::parse(lexeme_consumer &consumer) -> void
 {
-    consumer.assert_lexemes({ expect(lexeme_type::directive, "import").t() });
+    consumer.assert_lexemes<pattern::directive<keyword::import>>();
 
-    if (consumer.expect( expect(lexeme_type::string).t() )) {
+    if (consumer.expect<pattern::string>()) {
         auto relative_path = consumer.read();
         auto absolute_path = relative_path.file_reference().file().relative_path(relative_path.string_value());
-        auto file = std::make_shared<source_file>("", absolute_path);
+        auto& registry = source_registry::shared();
+        auto file = registry.load(absolute_path);
 
-        lexer sub_lexer { file };
-        consumer.insert(sub_lexer.scan(), 1);
+        // Files that have already been imported are skipped when include once is enabled.
+        if (!registry.should_include(file)) {
+            return;
+        }
+
+        auto tokens = registry.tokens(file);
+        registry.prefetch_imports(*tokens);
+        consumer.insert(tokens, 1);
     }
-    else if (consumer.expect( expect(lexeme_type::identifier, "ResEdit").t() )) {
+    else if (consumer.expect<pattern::ident<keyword::res_edit>>()) {
         consumer.advance();
         builtin::resedit::import(consumer);
     }
-    else if (consumer.expect( expect(lexeme_type::identifier, "POSIX").t() )) {
+    else if (consumer.expect<pattern::ident<keyword::posix>>()) {
         consumer.advance();
         builtin::posix::import(consumer);
     }
-    else if (consumer.expect( expect(lexeme_type::identifier, "KestrelFoundation").t() )) {
+    else if (consumer.expect<pattern::ident<keyword::kestrel_foundation>>()) {
         consumer.advance();
         builtin::kestrel::import(consumer);
     }
@@ -23,9 +23,9 @@
 
 auto kdl::lib::sema::directive::out::parse(lexeme_consumer& consumer) -> void
 {
-    consumer.assert_lexemes({ expect(lexeme_type::directive, "out").t() });
+    consumer.assert_lexemes<pattern::directive<keyword::out>>();
 
-    while (consumer.expect( expect(lexeme_type::semicolon).f() )) {
+    while (consumer.expect<pattern::not_<pattern::semicolon>>()) {
         std::cout << consumer.read().string_value();
     }
 
@@ -24,9 +24,9 @@
 
 auto kdl::lib::sema::directive::version::parse(lexeme_consumer &consumer, const std::shared_ptr<module>& project) -> void
 {
-    consumer.assert_lexemes({ expect(lexeme_type::directive, "version").t() });
+    consumer.assert_lexemes<pattern::directive<keyword::version>>();
 
-    if (!consumer.expect( expect(lexeme_type::string).t() )) {
+    if (!consumer.expect<pattern::string>()) {
         report::warn(consumer.peek(), "Expected string for version.");
     }
 
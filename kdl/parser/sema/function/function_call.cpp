@@ -28,14 +28,14 @@ auto kdl::lib::sema::function::call::look_ahead(kdl::lib::lexeme_consumer &consu
     // Peek forwards and attempt to build an identifier path that is followed by a '('
     // This is required for a function call.
     consumer.save_position();
-    while (consumer.expect({ expect(lexeme_type::identifier).t() })) {
+    while (consumer.expect<pattern::identifier>()) {
         consumer.advance();
-        if (consumer.expect({ expect(lexeme_type::scope).t() })) {
+        if (consumer.expect<pattern::scope>()) {
             path_length++;
             consumer.advance();
             continue;
         }
-        else if (consumer.expect({ expect(lexeme_type::lparen).t() })) {
+        else if (consumer.expect<pattern::lparen>()) {
             path_length++;
             break;
         }
@@ -32,25 +32,25 @@
 
 namespace kdl::lib::spec::keywords
 {
-    constexpr const char *project { "project" };
-    constexpr const char *module { "module" };
-    constexpr const char *author { "author" };
-    constexpr const char *version { "version" };
-    constexpr const char *copyright { "copyright" };
-    constexpr const char *out { "out" };
-    constexpr const char *define { "define" };
-    constexpr const char *declare { "declare" };
-    constexpr const char *component { "component" };
-    constexpr const char *name_space { "namespace" };
-    constexpr const char *scene { "scene" };
+    constexpr lib::keyword project { lib::keyword::project };
+    constexpr lib::keyword module { lib::keyword::module };
+    constexpr lib::keyword author { lib::keyword::author };
+    constexpr lib::keyword version { lib::keyword::version };
+    constexpr lib::keyword copyright { lib::keyword::copyright };
+    constexpr lib::keyword out { lib::keyword::out };
+    constexpr lib::keyword define { lib::keyword::define };
+    constexpr lib::keyword declare { lib::keyword::declare };
+    constexpr lib::keyword component { lib::keyword::component };
+    constexpr lib::keyword name_space { lib::keyword::name_space };
+    constexpr lib::keyword scene { lib::keyword::scene };
 }
 
 auto kdl::lib::sema::module::parse(lexeme_consumer& consumer, const std::weak_ptr<name_space>& ns, std::vector<std::shared_ptr<class module>>& modules) -> void
 {
-    if (!consumer.expect_all({
-        expect(lexeme_type::directive).t(),
-        expect(lexeme_type::identifier).t()
-    })) {
+    if (!consumer.expect<pattern::seq<
+        pattern::token<lexeme_type::directive>,
+        pattern::identifier
+    >>()) {
         report::error(consumer.peek(), "Unexpected token sequence encountered.");
     }
 
@@ -59,10 +59,10 @@ auto kdl::lib::sema::module::parse(lexeme_consumer& consumer, const std::weak_pt
     auto module_name = consumer.read();
     auto module_type = module_type::module;
 
-    if (directive.string_value() == spec::keywords::project) {
+    if (directive.is(spec::keywords::project)) {
         module_type = module_type::project;
     }
-    else if (directive.string_value() == spec::keywords::module) {
+    else if (directive.is(spec::keywords::module)) {
         module_type = module_type::module;
     }
     else {
@@ -91,14 +91,14 @@ auto kdl::lib::sema::module::parse(lexeme_consumer& consumer, const std::weak_pt
 
 auto kdl::lib::sema::module::parse_into(kdl::lib::lexeme_consumer &consumer, const std::shared_ptr<struct module> &module) -> void
 {
-    consumer.assert_lexemes({ expect(lexeme_type::lbrace).t() });
-    while (consumer.expect({ expect(lexeme_type::rbrace).f() })) {
+    consumer.assert_lexemes<pattern::lbrace>();
+    while (consumer.expect<pattern::not_<pattern::rbrace>>()) {
 
         // DIRECTIVES
-        if (consumer.expect_all({
-            expect(lexeme_type::directive, spec::keywords::name_space).t(),
-            expect(lexeme_type::identifier).t()
-        })) {
+        if (consumer.expect<pattern::seq<
+            pattern::directive<spec::keywords::name_space>,
+            pattern::identifier
+        >>()) {
             consumer.advance();
             if (module->get_namespace().expired()) {
                 report::error(consumer.peek(), "Module namespace is missing. This is a fatal error.");
@@ -106,30 +106,30 @@ auto kdl::lib::sema::module::parse_into(kdl::lib::lexeme_consumer &consumer, con
             auto parent = module->get_namespace().lock();
             module->set_namespace(parent->create(consumer.read().string_value()));
         }
-        else if (consumer.expect({ expect(lexeme_type::directive, spec::keywords::author).t() })) {
+        else if (consumer.expect<pattern::directive<spec::keywords::author>>()) {
             sema::directive::author::parse(consumer, module);
         }
-        else if (consumer.expect({ expect(lexeme_type::directive, spec::keywords::version).t() })) {
+        else if (consumer.expect<pattern::directive<spec::keywords::version>>()) {
             sema::directive::version::parse(consumer, module);
         }
-        else if (consumer.expect({ expect(lexeme_type::directive, spec::keywords::copyright).t() })) {
+        else if (consumer.expect<pattern::directive<spec::keywords::copyright>>()) {
             sema::directive::copyright::parse(consumer, module);
         }
-        else if (consumer.expect({ expect(lexeme_type::directive, spec::keywords::out).t() })) {
+        else if (consumer.expect<pattern::directive<spec::keywords::out>>()) {
             sema::directive::out::parse(consumer);
         }
 
         // FUNCTIONS
-        else if (consumer.expect({ expect(lexeme_type::identifier, spec::keywords::define).t() })) {
+        else if (consumer.expect<pattern::ident<spec::keywords::define>>()) {
             sema::define::parse(consumer, module);
         }
-        else if (consumer.expect({ expect(lexeme_type::identifier, spec::keywords::declare).t() })) {
+        else if (consumer.expect<pattern::ident<spec::keywords::declare>>()) {
             sema::declare::parse(consumer, module);
         }
-        else if (consumer.expect({ expect(lexeme_type::identifier, spec::keywords::component).t() })) {
+        else if (consumer.expect<pattern::ident<spec::keywords::component>>()) {
 
         }
-        else if (consumer.expect({ expect(lexeme_type::identifier, spec::keywords::scene).t() })) {
+        else if (consumer.expect<pattern::ident<spec::keywords::scene>>()) {
             sema::project::scene::parse(consumer, module);
         }
 
@@ -137,7 +137,8 @@ auto kdl::lib::sema::module::parse_into(kdl::lib::lexeme_consumer &consumer, con
             report::error(consumer.peek(), "Unexpected token encountered in module.");
         }
 
-        consumer.assert_lexemes({ expect(lexeme_type::semicolon).t() });
+        consumer.assert_lexemes<pattern::semicolon>();
+        consumer.discard_consumed();
     }
-    consumer.assert_lexemes({ expect(lexeme_type::rbrace).t() });
+    consumer.assert_lexemes<pattern::rbrace>();
 }
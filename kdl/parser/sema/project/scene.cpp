@@ -26,52 +26,52 @@
 
 namespace kdl::lib::spec::keywords
 {
-    constexpr const char *scene { "scene" };
-    constexpr const char *event { "event" };
+    constexpr lib::keyword scene { lib::keyword::scene };
+    constexpr lib::keyword event { lib::keyword::event };
 }
 
 auto kdl::lib::sema::project::scene::parse(lexeme_consumer &consumer, const std::shared_ptr<kdl::lib::module> &module) -> void
 {
-    if (!consumer.expect_all({
-        expect(lexeme_type::identifier, spec::keywords::scene).t(),
-        expect(lexeme_type::identifier).t(),
-        expect(lexeme_type::lbrace).t()
-    })) {
+    if (!consumer.expect<pattern::seq<
+        pattern::ident<spec::keywords::scene>,
+        pattern::identifier,
+        pattern::lbrace
+    >>()) {
         report::error(consumer.peek(), "Expected scene structure");
     }
 
     consumer.advance();
-    auto scene_name = consumer.read();
+    const auto& scene_name = consumer.read();
     consumer.advance();
 
     auto scene = std::make_shared<class kdl::lib::scene>(scene_name.string_value());
 
-    while (consumer.expect( expect(lexeme_type::rbrace).f() )) {
-        if (consumer.expect_all({
-            expect(lexeme_type::identifier, spec::keywords::event).t(),
-            expect(lexeme_type::lparen).t(),
-            expect(lexeme_type::identifier).t(),
-            expect(lexeme_type::rparen).t(),
-            expect(lexeme_type::equals).t(),
-            expect(lexeme_type::lbracket).t()
-        })) {
+    while (consumer.expect<pattern::not_<pattern::rbrace>>()) {
+        if (consumer.expect<pattern::seq<
+            pattern::ident<spec::keywords::event>,
+            pattern::lparen,
+            pattern::identifier,
+            pattern::rparen,
+            pattern::equals,
+            pattern::lbracket
+        >>()) {
             consumer.advance(2);
-            auto event_name = consumer.read();
+            const auto& event_name = consumer.read();
             consumer.advance(3);
 
             std::vector<lexeme> scripts;
-            while (consumer.expect( expect(lexeme_type::rbracket).f() )) {
-                if (consumer.expect( expect(lexeme_type::resource_ref).t() )) {
+            while (consumer.expect<pattern::not_<pattern::rbracket>>()) {
+                if (consumer.expect<pattern::resource_ref>()) {
                     scripts.emplace_back(consumer.read());
                 }
                 else {
                     report::error(consumer.peek(), "Unexpected value provided.");
                 }
 
-                if (consumer.expect( expect(lexeme_type::rbracket).t() )) {
+                if (consumer.expect<pattern::rbracket>()) {
                     break;
                 }
-                else if (consumer.expect( expect(lexeme_type::comma).t() )) {
+                else if (consumer.expect<pattern::comma>()) {
                     consumer.advance();
                     continue;
                 }
@@ -80,32 +80,38 @@ auto kdl::lib::sema::project::scene::parse(lexeme_consumer &consumer, const std:
                 }
             }
 
-            consumer.assert_lexemes({ expect(lexeme_type::rbracket).t() });
+            consumer.assert_lexemes<pattern::rbracket>();
         }
-        else if (consumer.expect_all({
-            expect(lexeme_type::identifier).t(), expect(lexeme_type::equals).t(),
-            expect(lexeme_type::identifier).f()
-        })) {
-            auto attribute = consumer.read();
+        else if (consumer.expect<pattern::seq<
+            pattern::identifier,
+            pattern::equals,
+            pattern::not_<pattern::identifier>
+        >>()) {
+            const auto& attribute = consumer.read();
             consumer.advance();
 
             std::vector<lexeme> v;
-            while (consumer.expect_any({
-                expect(lexeme_type::identifier).t(), expect(lexeme_type::color).t(),
-                expect(lexeme_type::any_integer).t(), expect(lexeme_type::any_string).t(),
-                expect(lexeme_type::resource_ref).t(), expect(lexeme_type::percentage).t(),
-                expect(lexeme_type::hex).t(), expect(lexeme_type::character).t(),
-            })) {
+            while (consumer.expect<pattern::any<
+                pattern::identifier,
+                pattern::color,
+                pattern::token<lexeme_type::any_integer>,
+                pattern::token<lexeme_type::any_string>,
+                pattern::resource_ref,
+                pattern::percentage,
+                pattern::hex,
+                pattern::token<lexeme_type::character>
+            >>()) {
                 v.emplace_back(consumer.read());
             }
 
             scene->set_attribute(attribute.string_value(), v);
         }
-        else if (consumer.expect_all({
-            expect(lexeme_type::identifier).t(), expect(lexeme_type::equals).t(),
-            expect(lexeme_type::identifier).t()
-        })) {
-            auto attribute = consumer.read();
+        else if (consumer.expect<pattern::seq<
+            pattern::identifier,
+            pattern::equals,
+            pattern::identifier
+        >>()) {
+            const auto& attribute = consumer.read();
             consumer.advance();
 
             auto result = consumer.peek();
@@ -123,9 +129,9 @@ auto kdl::lib::sema::project::scene::parse(lexeme_consumer &consumer, const std:
             report::error(consumer.peek(), "Unexpected token in scene.");
         }
 
-        consumer.assert_lexemes({ expect(lexeme_type::semicolon).t() });
+        consumer.assert_lexemes<pattern::semicolon>();
     }
 
-    consumer.assert_lexemes({ expect(lexeme_type::rbrace).t() });
+    consumer.assert_lexemes<pattern::rbrace>();
     module->add_scene(scene);
 }
\ No newline at end of file
@@ -0,0 +1,171 @@
+// Copyright (c) 2021 Tom Hancocks
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <kdl/schema/atom.hpp>
+
+// MARK: - Atom Table
+
+namespace kdl::lib
+{
+    /* The table is split in to shards by the hash of the name, so that threads interning different names rarely
+     * contend for the same lock. The text of each atom lives in segments that never move once they have been
+     * published, so resolving an atom takes no lock at all.
+     */
+    class atom_table
+    {
+    public:
+        atom_table()
+        {
+            m_segments[0].store(new std::string[segment_size], std::memory_order_release);
+            m_count.store(1, std::memory_order_release);
+        }
+
+        ~atom_table()
+        {
+            for (auto& segment : m_segments) {
+                delete[] segment.load();
+            }
+        }
+
+        static auto shared() -> atom_table&
+        {
+            static atom_table table;
+            return table;
+        }
+
+        auto find(std::string_view name) -> std::uint32_t
+        {
+            auto& shard = shard_for(name);
+            std::shared_lock<std::shared_mutex> lock(shard.lock);
+            auto it = shard.ids.find(name);
+            return (it == shard.ids.end()) ? 0 : it->second;
+        }
+
+        auto intern(std::string_view name) -> std::uint32_t
+        {
+            if (name.empty()) {
+                return 0;
+            }
+            if (auto id = find(name)) {
+                return id;
+            }
+
+            auto& shard = shard_for(name);
+            std::unique_lock<std::shared_mutex> lock(shard.lock);
+            if (auto it = shard.ids.find(name); it != shard.ids.end()) {
+                return it->second;
+            }
+
+            auto id = allocate(name);
+            shard.ids.emplace(string(id), id);
+            return id;
+        }
+
+        auto string(std::uint32_t id) const -> const std::string&
+        {
+            return m_segments[id / segment_size].load(std::memory_order_acquire)[id % segment_size];
+        }
+
+    private:
+        static constexpr std::size_t shard_count { 16 };
+        static constexpr std::size_t segment_size { 4096 };
+        static constexpr std::size_t segment_count { 4096 };
+
+        struct shard
+        {
+            std::shared_mutex lock;
+            std::unordered_map<std::string_view, std::uint32_t> ids;
+        };
+
+        auto shard_for(std::string_view name) -> shard&
+        {
+            return m_shards[std::hash<std::string_view>()(name) % shard_count];
+        }
+
+        auto allocate(std::string_view name) -> std::uint32_t
+        {
+            std::lock_guard<std::mutex> lock(m_allocation_lock);
+            auto id = m_count.load(std::memory_order_relaxed);
+            auto segment = id / segment_size;
+            if (segment >= segment_count) {
+                throw std::length_error("Too many names have been interned.");
+            }
+
+            auto entries = m_segments[segment].load(std::memory_order_relaxed);
+            if (!entries) {
+                entries = new std::string[segment_size];
+                m_segments[segment].store(entries, std::memory_order_release);
+            }
+            entries[id % segment_size] = std::string(name);
+            m_count.store(id + 1, std::memory_order_release);
+            return id;
+        }
+
+        std::array<shard, shard_count> m_shards;
+        std::array<std::atomic<std::string *>, segment_count> m_segments {};
+        std::mutex m_allocation_lock;
+        std::atomic<std::uint32_t> m_count { 0 };
+    };
+}
+
+// MARK: - Construction
+
+kdl::lib::atom::atom(std::string_view name)
+    : m_id(atom_table::shared().intern(name))
+{
+
+}
+
+auto kdl::lib::atom::find(std::string_view name) -> std::optional<atom>
+{
+    if (name.empty()) {
+        return atom();
+    }
+
+    atom result;
+    result.m_id = atom_table::shared().find(name);
+    if (result.m_id == 0) {
+        return {};
+    }
+    return result;
+}
+
+// MARK: - Accessors
+
+auto kdl::lib::atom::id() const -> std::uint32_t
+{
+    return m_id;
+}
+
+auto kdl::lib::atom::string() const -> const std::string&
+{
+    return atom_table::shared().string(m_id);
+}
+
+auto kdl::lib::atom::empty() const -> bool
+{
+    return m_id == 0;
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2021 Tom Hancocks
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <cstdint>
+#include <functional>
+
+namespace kdl::lib
+{
+    /* An atom is an interned name. Every distinct name is assigned a stable 32-bit id the first time that it is
+     * interned, and the text of an atom is stored once for the lifetime of the process. Comparing two atoms only
+     * compares their ids.
+     *
+     * Names can be interned and resolved from any thread. The default atom is the empty name.
+     */
+    class atom
+    {
+    public:
+        atom() = default;
+        explicit atom(std::string_view name);
+
+        [[nodiscard]] static auto find(std::string_view name) -> std::optional<atom>;
+
+        [[nodiscard]] auto id() const -> std::uint32_t;
+        [[nodiscard]] auto string() const -> const std::string&;
+        [[nodiscard]] auto empty() const -> bool;
+
+        auto operator==(const atom& other) const -> bool { return m_id == other.m_id; }
+        auto operator!=(const atom& other) const -> bool { return m_id != other.m_id; }
+        auto operator<(const atom& other) const -> bool { return m_id < other.m_id; }
+
+    private:
+        std::uint32_t m_id { 0 };
+    };
+}
+
+namespace std
+{
+    template<>
+    struct hash<kdl::lib::atom>
+    {
+        auto operator()(const kdl::lib::atom& a) const noexcept -> std::size_t
+        {
+            return std::hash<std::uint32_t>()(a.id());
+        }
+    };
+}
@@ -31,7 +31,12 @@ kdl::lib::binary_template::binary_template(const std::string& name)
 
 // MARK: - Accessors
 
-auto kdl::lib::binary_template::name() const -> std::string
+auto kdl::lib::binary_template::name() const -> const std::string&
+{
+    return m_name.string();
+}
+
+auto kdl::lib::binary_template::name_atom() const -> atom
 {
     return m_name;
 }
@@ -57,8 +62,9 @@ auto kdl::lib::binary_template::field_at(std::size_t i) const -> std::shared_ptr
 
 auto kdl::lib::binary_template::field_named(const std::string& name) const -> std::weak_ptr<binary_template_field>
 {
+    const auto key = atom::find(name);
     for (auto& field : m_fields) {
-        if (field->name() == name) {
+        if (key && field->name_atom() == *key) {
             return field;
         }
     }
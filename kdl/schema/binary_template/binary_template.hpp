@@ -26,6 +26,7 @@
 #include <memory>
 #include <unordered_map>
 #include <kdl/schema/binary_type/binary_type.hpp>
+#include <kdl/schema/atom.hpp>
 
 namespace kdl::lib
 {
@@ -34,7 +35,7 @@ namespace kdl::lib
     struct binary_template
     {
     private:
-        std::string m_name;
+        atom m_name;
         std::vector<std::shared_ptr<binary_template_field>> m_fields;
 
     public:
@@ -42,7 +43,9 @@ namespace kdl::lib
 
         auto add_field(const std::shared_ptr<binary_type>& type, const std::unordered_map<std::string, lexeme>& type_args, const std::string& name) -> void;
 
-        [[nodiscard]] auto name() const -> std::string;
+        [[nodiscard]] auto name() const -> const std::string&;
+
+        [[nodiscard]] auto name_atom() const -> atom;
 
         [[nodiscard]] auto field_count() const -> std::size_t;
         [[nodiscard]] auto field_at(std::size_t i) const -> std::shared_ptr<binary_template_field>;
@@ -37,7 +37,12 @@ auto kdl::lib::binary_template_field::type() const -> std::shared_ptr<binary_typ
     return m_type;
 }
 
-auto kdl::lib::binary_template_field::name() const -> std::string
+auto kdl::lib::binary_template_field::name() const -> const std::string&
+{
+    return m_name.string();
+}
+
+auto kdl::lib::binary_template_field::name_atom() const -> atom
 {
     return m_name;
 }
@@ -24,6 +24,7 @@
 #include <memory>
 #include <unordered_map>
 #include <kdl/lexer/lexeme.hpp>
+#include <kdl/schema/atom.hpp>
 
 namespace kdl::lib
 {
@@ -36,13 +37,14 @@ namespace kdl::lib
         binary_template_field(const std::shared_ptr<binary_type>& type, const std::unordered_map<std::string, lexeme>& type_args, const std::string& name);
 
         [[nodiscard]] auto type() const -> std::shared_ptr<binary_type>;
-        [[nodiscard]] auto name() const -> std::string;
+        [[nodiscard]] auto name() const -> const std::string&;
+        [[nodiscard]] auto name_atom() const -> atom;
         [[nodiscard]] auto type_args() const -> std::unordered_map<std::string, lexeme>;
 
     private:
         std::shared_ptr<binary_type> m_type;
         std::unordered_map<std::string, lexeme> m_type_args;
-        std::string m_name;
+        atom m_name;
     };
 
 }
\ No newline at end of file
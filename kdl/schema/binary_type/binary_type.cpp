@@ -66,7 +66,12 @@ auto kdl::lib::binary_type::set_attachments(const std::vector<lexeme> &attachmen
 
 // MARK: - Accessors
 
-auto kdl::lib::binary_type::name() const -> std::string
+auto kdl::lib::binary_type::name() const -> const std::string&
+{
+    return m_name.string();
+}
+
+auto kdl::lib::binary_type::name_atom() const -> atom
 {
     return m_name;
 }
@@ -108,9 +113,10 @@ auto kdl::lib::binary_type::char_encoding() const -> binary_type_char_encoding
 
 auto kdl::lib::binary_type::function_named(const std::string& name) const -> std::weak_ptr<struct function>
 {
+    const auto key = atom::find(name);
     for (auto& weak : m_functions) {
         auto fn = weak.lock();
-        if (fn && fn->name() == name) {
+        if (fn && key && fn->name_atom() == *key) {
             return fn;
         }
     }
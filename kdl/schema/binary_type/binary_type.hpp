@@ -27,6 +27,7 @@
 #include <kdl/lexer/lexeme.hpp>
 #include <kdl/schema/binary_type/isa.hpp>
 #include <kdl/schema/binary_type/char_encoding.hpp>
+#include <kdl/schema/atom.hpp>
 
 namespace kdl::lib
 {
@@ -46,7 +47,9 @@ namespace kdl::lib
         auto add_function(const std::shared_ptr<struct function>& fn) -> void;
         auto set_attachments(const std::vector<lexeme>& attachments) -> void;
 
-        [[nodiscard]] auto name() const -> std::string;
+        [[nodiscard]] auto name() const -> const std::string&;
+
+        [[nodiscard]] auto name_atom() const -> atom;
         [[nodiscard]] auto isa() const -> binary_type_isa;
         [[nodiscard]] auto is_signed() const -> bool;
         [[nodiscard]] auto size_type() const -> enum size_type;
@@ -60,7 +63,7 @@ namespace kdl::lib
         [[nodiscard]] auto is_fixed_size() const -> bool;
 
     private:
-        std::string m_name;
+        atom m_name;
         binary_type_isa m_isa { binary_type_isa::integer };
         bool m_signed { false };
         enum size_type m_size_type { size_type::width };
@@ -32,9 +32,14 @@ kdl::lib::function::function(const std::string& name, const std::shared_ptr<stru
 
 // MARK: - Accessors
 
-auto kdl::lib::function::name() const -> std::string
+auto kdl::lib::function::name() const -> const std::string&
 {
-    return  m_name;
+    return m_name.string();
+}
+
+auto kdl::lib::function::name_atom() const -> atom
+{
+    return m_name;
 }
 
 auto kdl::lib::function::construction_type() const -> std::weak_ptr<struct binary_type>
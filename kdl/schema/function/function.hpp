@@ -25,6 +25,7 @@
 #include <vector>
 #include <memory>
 #include <kdl/lexer/lexeme.hpp>
+#include <kdl/schema/atom.hpp>
 
 namespace kdl::lib
 {
@@ -34,7 +35,7 @@ namespace kdl::lib
     struct function
     {
     private:
-        std::string m_name;
+        atom m_name;
         std::weak_ptr<struct binary_type> m_construction_type;
         std::vector<struct function_argument> m_arguments;
         std::vector<lexeme> m_body;
@@ -42,7 +43,9 @@ namespace kdl::lib
     public:
         explicit function(const std::string& name, const std::shared_ptr<struct binary_type>& type = nullptr);
 
-        [[nodiscard]] auto name() const -> std::string;
+        [[nodiscard]] auto name() const -> const std::string&;
+
+        [[nodiscard]] auto name_atom() const -> atom;
         [[nodiscard]] auto construction_type() const -> std::weak_ptr<struct binary_type>;
         [[nodiscard]] auto arguments() const -> std::vector<struct function_argument>;
         [[nodiscard]] auto argument_type_at(std::size_t i) const -> std::weak_ptr<struct binary_type>;
@@ -31,7 +31,12 @@ kdl::lib::function_argument::function_argument(const std::shared_ptr<struct bina
 
 // MARK: - Accessors
 
-auto kdl::lib::function_argument::name() const -> std::string
+auto kdl::lib::function_argument::name() const -> const std::string&
+{
+    return m_name.string();
+}
+
+auto kdl::lib::function_argument::name_atom() const -> atom
 {
     return m_name;
 }
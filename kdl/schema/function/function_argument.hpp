@@ -23,6 +23,7 @@
 
 #include <string>
 #include <memory>
+#include <kdl/schema/atom.hpp>
 
 namespace kdl::lib
 {
@@ -32,12 +33,14 @@ namespace kdl::lib
     {
     private:
         std::weak_ptr<struct binary_type> m_type;
-        std::string m_name;
+        atom m_name;
 
     public:
         function_argument(const std::shared_ptr<struct binary_type>& type, const std::string& name);
 
-        [[nodiscard]] auto name() const -> std::string;
+        [[nodiscard]] auto name() const -> const std::string&;
+
+        [[nodiscard]] auto name_atom() const -> atom;
         [[nodiscard]] auto type() const -> std::weak_ptr<struct binary_type>;
     };
 }
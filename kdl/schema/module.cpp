@@ -75,8 +75,9 @@ auto kdl::lib::module::add_submodule(const std::shared_ptr<module>& submodule) -
 
 auto kdl::lib::module::submodule_named(const std::string& name) const -> std::weak_ptr<module>
 {
+    const auto key = atom::find(name);
     for (auto& submodule : m_submodules) {
-        if (submodule->m_module_name == name) {
+        if (key && submodule->m_module_name == *key) {
             return submodule->shared_from_this();
         }
     }
@@ -85,7 +86,12 @@ auto kdl::lib::module::submodule_named(const std::string& name) const -> std::we
 
 // MARK: - Accessors
 
-auto kdl::lib::module::name() const -> std::string
+auto kdl::lib::module::name() const -> const std::string&
+{
+    return m_module_name.string();
+}
+
+auto kdl::lib::module::name_atom() const -> atom
 {
     return m_module_name;
 }
@@ -145,8 +151,9 @@ auto kdl::lib::module::add_binary_type_definition(const std::shared_ptr<binary_t
 auto kdl::lib::module::binary_type_named(const std::string& name, const std::vector<std::string>& path) -> std::weak_ptr<binary_type>
 {
     if (path.size() == 1 && path.at(0) == "this") {
+        const auto key = atom::find(name);
         for (const auto& type : m_binary_type_definitions) {
-            if (type->name() == name) {
+            if (key && type->name_atom() == *key) {
                 return type;
             }
         }
@@ -176,8 +183,9 @@ auto kdl::lib::module::add_binary_template_definition(const std::shared_ptr<bina
 auto kdl::lib::module::binary_template_named(const std::string& name, const std::vector<std::string>& path) -> std::weak_ptr<binary_template>
 {
     if (path.size() == 1 && path.at(0) == "this") {
+        const auto key = atom::find(name);
         for (const auto& tmpl : m_template_definitions) {
-            if (tmpl->name() == name) {
+            if (key && tmpl->name_atom() == *key) {
                 return tmpl;
             }
         }
@@ -211,8 +219,9 @@ auto kdl::lib::module::add_resource_type_definition(const std::shared_ptr<resour
 auto kdl::lib::module::resource_type_named(const std::string& name, const std::vector<std::string>& path) -> std::weak_ptr<resource_type>
 {
     if (path.size() == 1 && path.at(0) == "this") {
+        const auto key = atom::find(name);
         for (const auto& type : m_resource_type_definitions) {
-            if (type->name() == name) {
+            if (key && type->name_atom() == *key) {
                 return type;
             }
         }
@@ -229,18 +238,18 @@ auto kdl::lib::module::resource_type_named(const std::string& name, const std::v
 
 auto kdl::lib::module::resource_types() -> std::vector<std::shared_ptr<resource_type>>
 {
-    std::unordered_set<std::string> type_names;
+    std::unordered_set<atom> type_names;
     std::vector<std::shared_ptr<resource_type>> types = m_resource_type_definitions;
 
     for (const auto& type : types) {
-        type_names.insert(type->name());
+        type_names.insert(type->name_atom());
     }
 
     if (auto ns = get_namespace().lock()) {
         for (const auto& res : m_resource_declarations) {
             if (auto type = ns->resource_type_named(res.first, {}).lock()) {
-                if (type_names.find(type->name()) == type_names.end()) {
-                    type_names.insert(type->name());
+                if (type_names.find(type->name_atom()) == type_names.end()) {
+                    type_names.insert(type->name_atom());
                     types.emplace_back(type);
                 }
             }
@@ -264,9 +273,11 @@ auto kdl::lib::module::add_function(const std::shared_ptr<function>& fn) -> void
 auto kdl::lib::module::function_named(const std::string& name, const std::string& type, const std::vector<std::string>& path) -> std::weak_ptr<function>
 {
     if (path.size() == 1 && path.at(0) == "this") {
+        const auto key = atom::find(name);
+        const auto type_key = atom::find(type);
         for (const auto& fn : m_functions) {
             auto construction_type = fn->construction_type().lock();
-            if (construction_type && fn->name() == name && construction_type->name() == type) {
+            if (construction_type && key && fn->name_atom() == *key && type_key && construction_type->name_atom() == *type_key) {
                 return fn;
             }
         }
@@ -26,6 +26,7 @@
 #include <optional>
 #include <unordered_map>
 #include <kdl/schema/module_type.hpp>
+#include <kdl/schema/atom.hpp>
 
 namespace kdl::lib
 {
@@ -48,7 +49,8 @@ namespace kdl::lib
         auto add_copyright(const std::string& copy) -> void;
         auto add_submodule(const std::shared_ptr<module>& submodule) -> void;
 
-        [[nodiscard]] auto name() const -> std::string;
+        [[nodiscard]] auto name() const -> const std::string&;
+        [[nodiscard]] auto name_atom() const -> atom;
         [[nodiscard]] auto submodule_named(const std::string&) const -> std::weak_ptr<module>;
         [[nodiscard]] auto copyright(bool complete = true) const -> std::vector<std::string>;
         [[nodiscard]] auto authors(bool complete = true) const -> std::vector<std::string>;
@@ -81,7 +83,7 @@ namespace kdl::lib
         std::weak_ptr<name_space> m_namespace;
         std::weak_ptr<module> m_parent;
         std::vector<std::shared_ptr<module>> m_submodules;
-        std::string m_module_name;
+        atom m_module_name;
         std::string m_version;
         std::vector<std::string> m_authors;
         std::vector<std::string> m_copyright;
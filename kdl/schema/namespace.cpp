@@ -70,8 +70,9 @@ auto kdl::lib::name_space::child_named(const std::string& name) -> std::shared_p
         return shared_from_this();
     }
 
+    const auto key = atom::find(name);
     for (const auto& child : m_children) {
-        if (child->m_name == name) {
+        if (key && child->m_name == *key) {
             return child;
         }
     }
@@ -115,8 +116,9 @@ auto kdl::lib::name_space::binary_type_named(const std::string& name, const std:
         return ns->binary_type_named(name, {});
     }
     else {
+        const auto key = atom::find(name);
         for (const auto& weak : m_binary_types) {
-            if (const auto& type = weak.lock(); type->name() == name) {
+            if (const auto& type = weak.lock(); key && type->name_atom() == *key) {
                 return weak;
             }
         }
@@ -142,8 +144,9 @@ auto kdl::lib::name_space::binary_template_named(const std::string& name, const
         return ns->binary_template_named(name, {});
     }
     else {
+        const auto key = atom::find(name);
         for (const auto& weak : m_binary_templates) {
-            if (const auto& tmpl = weak.lock(); tmpl->name() == name) {
+            if (const auto& tmpl = weak.lock(); key && tmpl->name_atom() == *key) {
                 return weak;
             }
         }
@@ -169,8 +172,9 @@ auto kdl::lib::name_space::resource_type_named(const std::string& name, const st
         return ns->resource_type_named(name, {});
     }
     else {
+        const auto key = atom::find(name);
         for (const auto& weak : m_resource_types) {
-            if (const auto& type = weak.lock(); type->name() == name) {
+            if (const auto& type = weak.lock(); key && type->name_atom() == *key) {
                 return weak;
             }
         }
@@ -196,11 +200,12 @@ auto kdl::lib::name_space::function_named(const std::string& name, const std::ve
         return ns->function_named(name, {});
     }
     else {
+        const auto key = atom::find(name);
         for (const auto& weak : m_functions) {
-            if (const auto& fn = weak.lock(); fn->name() == name) {
+            if (const auto& fn = weak.lock(); key && fn->name_atom() == *key) {
                 return weak;
             }
         }
         return {};
     }
-}
\ No newline at end of file
+}
@@ -24,6 +24,7 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <kdl/schema/atom.hpp>
 
 namespace kdl::lib
 {
@@ -36,7 +37,7 @@ namespace kdl::lib
     {
     private:
         // Global namespace has no name or parent.
-        std::string m_name;
+        atom m_name;
         std::weak_ptr<name_space> m_parent;
         std::vector<std::shared_ptr<name_space>> m_children;
         std::vector<std::weak_ptr<binary_type>> m_binary_types;
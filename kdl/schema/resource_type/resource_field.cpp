@@ -37,7 +37,12 @@ kdl::lib::resource_field::resource_field(const std::shared_ptr<struct resource_f
 
 // MARK: - Accessor
 
-auto kdl::lib::resource_field::name() const -> std::string
+auto kdl::lib::resource_field::name() const -> const std::string&
+{
+    return m_name.string();
+}
+
+auto kdl::lib::resource_field::name_atom() const -> atom
 {
     return m_name;
 }
@@ -24,6 +24,7 @@
 #include <string>
 #include <memory>
 #include <vector>
+#include <kdl/schema/atom.hpp>
 
 namespace kdl::lib
 {
@@ -32,14 +33,16 @@ namespace kdl::lib
     struct resource_field
     {
     private:
-        std::string m_name;
+        atom m_name;
         std::vector<std::shared_ptr<struct resource_field_value>> m_values;
 
     public:
         explicit resource_field(const std::string& name);
         explicit resource_field(const std::shared_ptr<struct resource_field_value>& field);
 
-        [[nodiscard]] auto name() const -> std::string;
+        [[nodiscard]] auto name() const -> const std::string&;
+
+        [[nodiscard]] auto name_atom() const -> atom;
 
         auto add_value(const std::shared_ptr<struct resource_field_value>& value) -> void;
         [[nodiscard]] auto values() const -> const std::vector<std::shared_ptr<struct resource_field_value>>&;
@@ -30,7 +30,12 @@ kdl::lib::resource_field_symbol::resource_field_symbol(const std::string &name,
 
 // MARK: - Accessors
 
-auto kdl::lib::resource_field_symbol::name() const -> std::string
+auto kdl::lib::resource_field_symbol::name() const -> const std::string&
+{
+    return m_name.string();
+}
+
+auto kdl::lib::resource_field_symbol::name_atom() const -> atom
 {
     return m_name;
 }
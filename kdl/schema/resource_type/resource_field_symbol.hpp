@@ -24,6 +24,7 @@
 #include <string>
 #include <memory>
 #include <kdl/lexer/lexeme.hpp>
+#include <kdl/schema/atom.hpp>
 
 namespace kdl::lib
 {
@@ -31,13 +32,15 @@ namespace kdl::lib
     struct resource_field_symbol
     {
     private:
-        std::string m_name;
+        atom m_name;
         lexeme m_value;
 
     public:
         explicit resource_field_symbol(const std::string& name, const lexeme& lx);
 
-        [[nodiscard]] auto name() const -> std::string;
+        [[nodiscard]] auto name() const -> const std::string&;
+
+        [[nodiscard]] auto name_atom() const -> atom;
         [[nodiscard]] auto type() const -> lexeme_type;
         [[nodiscard]] auto value() const -> lexeme;
     };
@@ -26,14 +26,19 @@
 // MARK: - Construction
 
 kdl::lib::resource_field_value::resource_field_value(const std::shared_ptr<struct binary_template_field>& field)
-    : m_binary_template_field_name(field->name()), m_binary_template_field(field)
+    : m_binary_template_field_name(field->name_atom()), m_binary_template_field(field)
 {
 
 }
 
 // MARK: - Accessors
 
-auto kdl::lib::resource_field_value::name() const -> std::string
+auto kdl::lib::resource_field_value::name() const -> const std::string&
+{
+    return m_binary_template_field_name.string();
+}
+
+auto kdl::lib::resource_field_value::name_atom() const -> atom
 {
     return m_binary_template_field_name;
 }
@@ -78,8 +83,9 @@ auto kdl::lib::resource_field_value::add_symbol(const std::shared_ptr<struct res
 
 auto kdl::lib::resource_field_value::symbol_named(const std::string &name) const -> std::weak_ptr<struct resource_field_symbol>
 {
+    const auto key = atom::find(name);
     for (auto& sym : m_symbols) {
-        if (sym->name() == name) {
+        if (key && sym->name_atom() == *key) {
             return sym;
         }
     }
@@ -26,6 +26,7 @@
 #include <vector>
 #include <optional>
 #include <kdl/lexer/lexeme.hpp>
+#include <kdl/schema/atom.hpp>
 
 namespace kdl::lib
 {
@@ -35,7 +36,7 @@ namespace kdl::lib
     struct resource_field_value
     {
     private:
-        std::string m_binary_template_field_name;
+        atom m_binary_template_field_name;
         std::weak_ptr<struct binary_template_field> m_binary_template_field;
         std::vector<std::shared_ptr<struct resource_field_symbol>> m_symbols;
         std::optional<lexeme> m_default_value;
@@ -45,7 +46,8 @@ namespace kdl::lib
 
         auto set_default_value(const lexeme& lx) -> void;
 
-        [[nodiscard]] auto name() const -> std::string;
+        [[nodiscard]] auto name() const -> const std::string&;
+        [[nodiscard]] auto name_atom() const -> atom;
         [[nodiscard]] auto default_value() const -> std::optional<lexeme>;
 
         auto add_symbol(const std::shared_ptr<struct resource_field_symbol>& symbol) -> void;
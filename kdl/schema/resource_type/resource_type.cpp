@@ -32,7 +32,12 @@ kdl::lib::resource_type::resource_type(const std::string &name, const std::strin
 
 // MARK: - Accessors
 
-auto kdl::lib::resource_type::name() const -> std::string
+auto kdl::lib::resource_type::name() const -> const std::string&
+{
+    return m_name.string();
+}
+
+auto kdl::lib::resource_type::name_atom() const -> atom
 {
     return m_name;
 }
@@ -68,8 +73,9 @@ auto kdl::lib::resource_type::fields() const -> const std::vector<std::shared_pt
 
 auto kdl::lib::resource_type::field_named(const std::string &name) const -> std::shared_ptr<resource_field>
 {
+    const auto key = atom::find(name);
     for (const auto& field : m_fields) {
-        if (field->name() == name) {
+        if (key && field->name_atom() == *key) {
             return field;
         }
     }
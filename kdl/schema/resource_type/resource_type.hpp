@@ -24,6 +24,7 @@
 #include <string>
 #include <memory>
 #include <vector>
+#include <kdl/schema/atom.hpp>
 
 namespace kdl::lib
 {
@@ -35,7 +36,9 @@ namespace kdl::lib
     public:
         resource_type(const std::string& name, const std::string& code);
 
-        [[nodiscard]] auto name() const -> std::string;
+        [[nodiscard]] auto name() const -> const std::string&;
+
+        [[nodiscard]] auto name_atom() const -> atom;
         [[nodiscard]] auto code() const -> std::string;
 
         auto set_uses_code_editor(bool f) -> void { m_use_code_editor = f; }
@@ -50,7 +53,7 @@ namespace kdl::lib
 
     private:
         bool m_use_code_editor { false };
-        std::string m_name;
+        atom m_name;
         std::string m_code;
         std::weak_ptr<struct binary_template> m_template;
         std::vector<std::shared_ptr<resource_field>> m_fields;